@@ -3,10 +3,15 @@
 
 #define STACK_SIZE 256
 
+// shared.events bits
+#define APP_EVENT_T1    0x01    // thread 1 changed inc
+#define APP_EVENT_T2    0x02    // thread 2 changed inc
+
 
 // typedefs
 typedef struct GlobalDataStr_t {
-	uint8_t guard;
+	kosSem_t lock;		// binary semaphore around inc
+	kosEvent_t events;	// APP_EVENT_xxx
 	uint8_t inc;
 	uint8_t t1;
 	uint8_t t2;
@@ -51,8 +56,8 @@ void thread2Entry(void *pData);
 /** 
  * Thread 3.
  * 
- * Casts pData to GlobalDataStr_t and checks the inc variable.
- * Returns error if inc is larger then 3.
+ * Casts pData to GlobalDataStr_t and checks the inc variable once both
+ * other threads have changed it. Resets inc if it is larger then 0x7F.
  * 
  * @param pData is a pointer to shared data
  * @return error code
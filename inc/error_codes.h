@@ -29,6 +29,12 @@
 // OS Error Codes
 #define OS_ERROR_BASE		0x0
 #define OS_ERR				(ERROR_BASE|(OS_ERROR_BASE+1))
+#define OS_ERR_POST_FULL	(ERROR_BASE|(OS_ERROR_BASE+2))
+#define OS_ERR_TIMEOUT		(ERROR_BASE|(OS_ERROR_BASE+3))
+#define OS_ERR_DELETED		(ERROR_BASE|(OS_ERROR_BASE+4))
+#define OS_ERR_SEM_OVF		(ERROR_BASE|(OS_ERROR_BASE+5))
+#define OS_ERR_NOT_OWNER	(ERROR_BASE|(OS_ERROR_BASE+6))
+#define OS_ERR_QUEUE_FULL	(ERROR_BASE|(OS_ERROR_BASE+7))
 
 //------------------------------------------------------
 // General Error Codes
@@ -0,0 +1,171 @@
+/** 
+ * 
+ * \file os_ao.h
+ * Active objects
+ *
+ * An active object is a state machine with its own thread and event
+ * queue. The thread takes one event at a time and hands it to the
+ * object's dispatch function, which runs to completion before the next
+ * event is taken, so the object's data needs no locking.
+ *
+ * Events are kosBuf_t buffers from a buffer pool, the signal is the
+ * buffer's tag. The queue is a mailbox, so an object can also be
+ * subscribed to bus topics, which arrive with the topic as the signal.
+ * Each object has one timer, which delivers a signal of its choosing
+ * after a number of ticks, once or periodically.
+ *
+ * Requires os_queue.h and os_mbox.h.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_AO_H_
+#define OS_AO_H_
+
+
+// Signals
+#define KOS_AO_SIG_INIT         0       // first event of every object, before any posted
+#define KOS_AO_SIG_USER         1       // first signal free for the application
+
+//--------------------------------------------------------------
+// typedefs
+
+struct kosAo_t;
+
+typedef void (kosAoDispatch_t)(struct kosAo_t *pAo, kosBuf_t *pEvt);
+
+	// Active object, allocated by the caller and set up with kos_AoCreate
+typedef struct kosAo_t {
+	kosMbox_t queue;				// events posted to the object
+	kosMbox_t deferred;				// events put aside with kos_AoDefer
+	kosAoDispatch_t *pDispatch;
+	void *pData;					// the object's state, for the dispatch function
+	kosBuf_t timeEvt;				// init and timer events, not from a pool
+	uint32_t timeSig;
+	uint32_t timeDue;				// tick the timer fires
+	uint32_t timePeriod;			// 0 for a one-shot timer
+	uint32_t timeArmed;
+}kosAo_t;
+
+
+/** 
+ * Create an active object.
+ * 
+ * Does not enter the kernel. The object does nothing until
+ * kos_AoStart, but events can be posted to it before then.
+ * 
+ * @param pAo is the active object
+ * @param pDispatch is called with each event
+ * @param pData is the object's state, kept in pAo->pData
+ * @param pQueue is KOS_MBOX_BUFFER_WORDS(queueLen) words
+ * @param queueLen is the number of events the queue holds
+ * @param pDefer is KOS_MBOX_BUFFER_WORDS(deferLen) words, 0 if the object never defers
+ * @param deferLen is the number of events that can be deferred
+ * @return error code
+ */
+extern
+uint32_t kos_AoCreate(kosAo_t *pAo, kosAoDispatch_t *pDispatch, void *pData,
+		uint32_t *pQueue, uint32_t queueLen, uint32_t *pDefer, uint32_t deferLen);
+
+
+/** 
+ * Start an active object's thread.
+ * 
+ * The thread first dispatches KOS_AO_SIG_INIT, then the posted events.
+ * 
+ * @param pAo is the active object
+ * @param pri is the priority of its thread
+ * @param pszName is the name of its thread
+ * @param stack is the thread's stack
+ * @param stackSize is the size of the stack in words
+ * @return error code
+ */
+extern
+uint32_t kos_AoStart(kosAo_t *pAo, uint8_t pri, const char *pszName, KOS_STK *stack, uint32_t stackSize);
+
+
+/** 
+ * Post an event to an active object.
+ * 
+ * Adds a reference for the object and never blocks. The caller keeps
+ * its own reference, as with kos_MboxPost. Not for ISRs.
+ * 
+ * @param pAo is the active object
+ * @param pEvt is the event, its tag is the signal
+ * @return error code, OS_ERR_TIMEOUT if the queue is full
+ */
+extern
+uint32_t kos_AoPost(kosAo_t *pAo, kosBuf_t *pEvt);
+
+
+/** 
+ * Post an event to an active object from an ISR.
+ * 
+ * @param pAo is the active object
+ * @param pEvt is the event, from kos_BufAllocFromISR
+ * @return error code, OS_ERR_QUEUE_FULL if the queue is full
+ */
+extern KOS_RAMFUNC
+uint32_t kos_AoPostFromISR(kosAo_t *pAo, kosBuf_t *pEvt);
+
+
+/** 
+ * Put the event being dispatched aside.
+ * 
+ * For an event the object cannot handle in its current state. Call
+ * from the object's dispatch function, then kos_AoRecall once it can.
+ * Init and timer events cannot be deferred.
+ * 
+ * @param pAo is the active object
+ * @param pEvt is the event being dispatched
+ * @return error code, OS_ERR_TIMEOUT if the deferred queue is full
+ */
+extern
+uint32_t kos_AoDefer(kosAo_t *pAo, kosBuf_t *pEvt);
+
+
+/** 
+ * Post the oldest deferred event back to the object.
+ * 
+ * It goes to the back of the queue. If the queue is full it stays
+ * deferred. Call from the object's dispatch function.
+ * 
+ * @param pAo is the active object
+ * @return error code, OS_ERR_TIMEOUT if nothing was deferred or the queue is full
+ */
+extern
+uint32_t kos_AoRecall(kosAo_t *pAo);
+
+
+/** 
+ * Arm the object's timer.
+ * 
+ * Replaces any earlier setting. The timer event is dispatched between
+ * posted events, once it is due. Call from the object's dispatch
+ * function.
+ * 
+ * @param pAo is the active object
+ * @param sig is the signal of the timer event
+ * @param ticks is the number of ticks to the first event, at least 1
+ * @param period is the number of ticks between events, 0 for just one
+ * @return error code
+ */
+extern
+uint32_t kos_AoTimerArm(kosAo_t *pAo, uint32_t sig, uint32_t ticks, uint32_t period);
+
+
+/** 
+ * Disarm the object's timer.
+ * 
+ * Call from the object's dispatch function.
+ * 
+ * @param pAo is the active object
+ * @return error code
+ */
+extern
+uint32_t kos_AoTimerDisarm(kosAo_t *pAo);
+
+
+#endif /*OS_AO_H_*/
@@ -0,0 +1,85 @@
+/** 
+ * 
+ * \file os_atomic.h
+ * Atomic operations on 32 bit words
+ *
+ * The ARM7TDMI has no exclusive loads and stores. kos_AtomicSwap is a
+ * single SWP instruction and works anywhere. The others run with IRQ
+ * and FIQ masked for a few instructions in privileged modes, and
+ * through a short SWI from USER mode threads, which masks IRQ only. A
+ * FIQ handler may therefore only use kos_AtomicSwap on words a USER
+ * thread changes.
+ *
+ * The word must be word aligned. Each call returns the value the word
+ * held before it.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_ATOMIC_H_
+#define OS_ATOMIC_H_
+
+
+/** 
+ * Exchange a word.
+ * 
+ * @param p is the word
+ * @param value is stored in it
+ * @return the old value
+ */
+extern KOS_RAMFUNC
+uint32_t kos_AtomicSwap(volatile uint32_t *p, uint32_t value);
+
+
+/** 
+ * Compare and swap a word.
+ * 
+ * Stores desired only if the word holds expected.
+ * 
+ * @param p is the word
+ * @param expected is the value the word must hold
+ * @param desired is stored if it does
+ * @return the old value, equal to expected if desired was stored
+ */
+extern KOS_RAMFUNC
+uint32_t kos_AtomicCas(volatile uint32_t *p, uint32_t expected, uint32_t desired);
+
+
+/** 
+ * Add to a word.
+ * 
+ * Subtract by adding the negated value.
+ * 
+ * @param p is the word
+ * @param value is added to it
+ * @return the old value
+ */
+extern KOS_RAMFUNC
+uint32_t kos_AtomicAdd(volatile uint32_t *p, uint32_t value);
+
+
+/** 
+ * Set bits in a word.
+ * 
+ * @param p is the word
+ * @param bits are ORed into it
+ * @return the old value
+ */
+extern KOS_RAMFUNC
+uint32_t kos_AtomicSetBits(volatile uint32_t *p, uint32_t bits);
+
+
+/** 
+ * Clear bits in a word.
+ * 
+ * @param p is the word
+ * @param bits are cleared in it
+ * @return the old value
+ */
+extern KOS_RAMFUNC
+uint32_t kos_AtomicClearBits(volatile uint32_t *p, uint32_t bits);
+
+
+#endif /*OS_ATOMIC_H_*/
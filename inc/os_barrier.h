@@ -0,0 +1,72 @@
+/** 
+ * 
+ * \file os_barrier.h
+ * Barriers
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_BARRIER_H_
+#define OS_BARRIER_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Barrier for a fixed number of threads, allocated by the caller and
+	// set up with kos_BarrierCreate. The phase and times are updated
+	// each time the barrier opens, threads may read them directly.
+typedef struct kosBarrier_t {
+	uint32_t parties;			// threads that must arrive to open it
+	uint32_t phase;				// times it has opened
+	uint32_t phaseStart;		// tick of the first arrival of this phase
+	uint32_t lastWait;			// ticks from first to last arrival, last phase
+	uint32_t maxWait;			// longest lastWait seen
+	kosWaitList_t waitList;		// arrivals waiting for the rest
+}kosBarrier_t;
+
+
+/** 
+ * Create a barrier.
+ * 
+ * Does not enter the kernel, so do it before any thread uses it.
+ * 
+ * @param pBarrier is the barrier
+ * @param parties is the number of threads that meet at it, at least 1
+ * @return error code
+ */
+extern
+uint32_t kos_BarrierCreate(kosBarrier_t *pBarrier, uint32_t parties);
+
+
+/** 
+ * Delete a barrier.
+ * 
+ * Every thread waiting at it wakes with OS_ERR_DELETED.
+ * 
+ * @param pBarrier is the barrier
+ * @return error code
+ */
+extern
+uint32_t kos_BarrierDelete(kosBarrier_t *pBarrier);
+
+
+/** 
+ * Wait at a barrier.
+ * 
+ * Blocks until all the parties have arrived, then they all carry on
+ * and the barrier is ready for the next phase. A thread that times out
+ * leaves, and no longer counts as arrived. Not for ISRs.
+ * 
+ * @param pBarrier is the barrier
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @param pWaited if not 0 gets the ticks this thread waited
+ * @return error code, OS_ERR_TIMEOUT if the rest did not arrive in time
+ */
+extern
+uint32_t kos_BarrierWait(kosBarrier_t *pBarrier, uint32_t timeout, uint32_t *pWaited);
+
+
+#endif /*OS_BARRIER_H_*/
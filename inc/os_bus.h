@@ -0,0 +1,86 @@
+/** 
+ * 
+ * \file os_bus.h
+ * Publish/subscribe event bus
+ *
+ * Events are kosBuf_t buffers from a pool. Each subscriber has its own
+ * mailbox and a topic lists the mailboxes subscribed to it, in a table
+ * fixed at build time, e.g.
+ *
+ *   static kosMbox_t * const faultSubs[] = { &ctrlMbox, &logMbox };
+ *   static kosMbox_t * const modeSubs[]  = { &ctrlMbox };
+ *   static const kosTopic_t topics[] = { KOS_TOPIC(faultSubs), KOS_TOPIC(modeSubs) };
+ *   kosBus_t bus = KOS_BUS(topics);
+ *
+ * Publishing posts the one buffer to every subscriber's mailbox, each
+ * with its own reference, so nothing is copied or allocated. A
+ * subscriber can receive several topics on one mailbox and tell them
+ * apart by the buffer's tag.
+ *
+ * Requires os_queue.h and os_mbox.h.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_BUS_H_
+#define OS_BUS_H_
+
+
+// Topic from an array of subscriber mailboxes
+#define KOS_TOPIC(subs)         { (subs), sizeof(subs)/sizeof((subs)[0]) }
+
+// Bus from an array of topics, the topic number is the index
+#define KOS_BUS(topics)         { (topics), sizeof(topics)/sizeof((topics)[0]) }
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Subscribers of one topic
+typedef struct kosTopic_t {
+	kosMbox_t * const *ppSubs;
+	uint32_t subCount;
+}kosTopic_t;
+
+	// Table of topics
+typedef struct kosBus_t {
+	const kosTopic_t *pTopics;
+	uint32_t topicCount;
+}kosBus_t;
+
+
+/** 
+ * Publish an event.
+ * 
+ * Sets the buffer's tag to the topic and posts it to every subscriber,
+ * without blocking. The caller's reference passes to the bus, so do not
+ * release it. A subscriber whose mailbox is full misses the event, the
+ * rest still get it. Not for ISRs, use kos_BusPublishFromISR.
+ * 
+ * @param pBus is the bus
+ * @param topic is the topic number
+ * @param pBuf is the event, with a reference owned by the caller
+ * @return error code, OS_ERR_QUEUE_FULL if a subscriber missed it
+ */
+extern
+uint32_t kos_BusPublish(kosBus_t *pBus, uint32_t topic, kosBuf_t *pBuf);
+
+
+/** 
+ * Publish an event from an ISR.
+ * 
+ * As kos_BusPublish. The buffer comes from kos_BufAllocFromISR. A
+ * subscriber whose wake is deferred by a full post queue still has the
+ * event, so that is not an error here.
+ * 
+ * @param pBus is the bus
+ * @param topic is the topic number
+ * @param pBuf is the event, with a reference owned by the ISR
+ * @return error code, OS_ERR_QUEUE_FULL if a subscriber missed it
+ */
+extern KOS_RAMFUNC
+uint32_t kos_BusPublishFromISR(kosBus_t *pBus, uint32_t topic, kosBuf_t *pBuf);
+
+
+#endif /*OS_BUS_H_*/
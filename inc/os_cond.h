@@ -0,0 +1,96 @@
+/** 
+ * 
+ * \file os_cond.h
+ * Condition variables
+ *
+ * Requires os_mutex.h.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_COND_H_
+#define OS_COND_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Condition variable, allocated by the caller and set up with kos_CondCreate
+typedef struct kosCond_t {
+	kosWaitList_t waitList;		// threads blocked in kos_CondWait
+}kosCond_t;
+
+
+/** 
+ * Create a condition variable.
+ * 
+ * Does not enter the kernel, so do it before any thread uses it.
+ * 
+ * @param pCond is the condition variable
+ * @return error code
+ */
+extern
+uint32_t kos_CondCreate(kosCond_t *pCond);
+
+
+/** 
+ * Delete a condition variable.
+ * 
+ * Every thread blocked on it wakes with OS_ERR_DELETED, once it has the
+ * mutex back.
+ * 
+ * @param pCond is the condition variable
+ * @return error code
+ */
+extern
+uint32_t kos_CondDelete(kosCond_t *pCond);
+
+
+/** 
+ * Wait on a condition variable.
+ * 
+ * The caller must own pMutex. In one step it unlocks the mutex, however
+ * many times it is locked, and blocks until the condition is signalled
+ * or the timeout runs out. It always returns with the mutex locked
+ * again as many times as before. The timeout only covers the wait for
+ * the signal, not the wait for the mutex after it. Check the condition
+ * again on return. Not for ISRs.
+ * 
+ * @param pCond is the condition variable
+ * @param pMutex is the mutex guarding the condition
+ * @param timeout is KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if not signalled in time
+ */
+extern
+uint32_t kos_CondWait(kosCond_t *pCond, kosMutex_t *pMutex, uint32_t timeout);
+
+
+/** 
+ * Signal a condition variable.
+ * 
+ * Wakes the highest priority waiter. It is moved straight onto the
+ * mutex and runs once it owns it.
+ * 
+ * @param pCond is the condition variable
+ * @return error code
+ */
+extern
+uint32_t kos_CondSignal(kosCond_t *pCond);
+
+
+/** 
+ * Signal every waiter of a condition variable.
+ * 
+ * Moves all of them onto their mutex in one pass, in priority order,
+ * instead of waking them all to fight over it.
+ * 
+ * @param pCond is the condition variable
+ * @return error code
+ */
+extern
+uint32_t kos_CondBroadcast(kosCond_t *pCond);
+
+
+#endif /*OS_COND_H_*/
@@ -8,11 +8,98 @@
 #define KOS_MAX_PRIORITIES      255
 #define KOS_LOWEST_PRIORITY     KOS_MAX_PRIORITIES-1
 
+#define KOS_MAX_THREAD_NAME_LEN 12
+
+// kos_CreateThreadEx flags
+#define KOS_THREAD_TRUSTED      0x01    // run in SYS mode, kernel and driver calls skip the SWI
+
+// Timeouts for the blocking calls, otherwise a number of ticks
+#define KOS_NO_WAIT             0           // fail with OS_ERR_TIMEOUT instead of blocking
+#define KOS_WAIT_FOREVER        0xFFFFFFFF
+
+// Place a function in RAM. crt.s copies the .ramfunc section there at
+// boot, so the code runs without MAM wait states. Flash and RAM are too
+// far apart for a BL, so KOS_RAMFUNC also makes calls to the function
+// long calls: put it on the prototype as well as the definition. Code in
+// RAM may only call other KOS_RAMFUNC functions, or through pointers.
+#define KOS_RAMFUNC             __attribute__ ((long_call, section(".ramfunc")))
+
+// Set KOS_USE_HOOKS to 1 (e.g. -DKOS_USE_HOOKS=1 in UDEFS) to enable the
+// switch-in, switch-out and thread-create hooks. When 0 the hook calls
+// and the registration functions compile to nothing.
+#ifndef KOS_USE_HOOKS
+#define KOS_USE_HOOKS           0
+#endif
+
 //--------------------------------------------------------------
 // typedefs
 
 typedef void (threadfunc_t)(void *pData);
 
+typedef enum threadState_t
+{
+	thread_active = 0,
+	thread_ready,
+	thread_waiting
+}threadState_t;
+
+
+typedef struct threadTCB_t {
+	volatile KOS_STK *stack; // must be first in TCB
+	uint32_t pri;					// running priority, raised while the thread owns a contended mutex
+	uint32_t basePri;				// priority given at create
+	uint32_t id;
+	threadState_t state;
+	char	name[KOS_MAX_THREAD_NAME_LEN];
+	uint32_t stackSize;
+	uint32_t flags;					// KOS_THREAD_xxx
+	struct threadTCB_t *pNext;		// priority round, while ready
+	struct threadTCB_t *pPrev;
+	uint32_t delay;					// ticks left while on the delay list, 0 otherwise
+	struct threadTCB_t *pDelayNext;
+	struct threadTCB_t *pDelayPrev;
+	struct kosWaitList_t *pWaitList;	// kernel object the thread is blocked on, 0 otherwise
+	struct threadTCB_t *pWaitNext;
+	struct threadTCB_t *pWaitPrev;
+	void *pWaitData;				// set by the blocking service for the object, e.g. the wait mask
+	struct kosWaitList_t *pOwned;	// objects the thread owns, linked through pOwnedNext
+	uint32_t notifyValue;			// kos_Notify value, not yet taken by kos_NotifyWait
+	uint32_t notifyState;			// KOS_NOTIFY_STATE_xxx bits
+}threadTCB_t, *pthreadTCB_t;
+
+// The TCB is kept at the start of the stack given to kos_CreateThread,
+// so the stack is also the thread's handle
+#define KOS_THREAD_HANDLE(stack)    ((threadTCB_t *)(stack))
+
+	// Threads blocked on a kernel object, highest priority first
+typedef struct kosWaitList_t {
+	threadTCB_t *pHead;
+	threadTCB_t *pOwner;				// lent the priority of the waiters, 0 if the object has no owner
+	struct kosWaitList_t *pOwnedNext;	// next object owned by pOwner
+}kosWaitList_t;
+
+	// Context switch hook, pOld is switched out and pNew switched in
+typedef void (kosSwitchHook_t)(threadTCB_t *pOld, threadTCB_t *pNew);
+
+	// Thread create hook, called once the new thread is on the ready list
+typedef void (kosCreateHook_t)(threadTCB_t *pThread);
+
+
+
+//--------------------------------------------------------------
+// critical.s, in RAM
+
+	// Disable IRQ and FIQ, returns the previous CPSR. Does nothing in user mode.
+extern KOS_RAMFUNC
+uint32_t InterruptsDisable(void);
+
+	// Enable IRQ and FIQ
+extern KOS_RAMFUNC
+void InterruptsEnable(uint32_t cpsr);
+
+	// Restore the CPSR returned by InterruptsDisable
+extern KOS_RAMFUNC
+void InterruptsRestore(uint32_t cpsr);
 
 
 /** 
@@ -30,9 +117,10 @@ uint32_t kos_InitOS(void);
 /** 
  * Adds a thread function to the schedular.
  * 
- * The lowest pri is 0, the highest 255. The name can be 
- * KOS_MAX_THREAD_NAME_LEN characters in length. The function pointer
- * must be type pthreadfunc_t.
+ * The highest pri is 0, the lowest KOS_LOWEST_PRIORITY, which belongs to
+ * the idle thread. The name can be KOS_MAX_THREAD_NAME_LEN characters in
+ * length. The function pointer must be type pthreadfunc_t. Goes through
+ * the kernel SWI, so it can be called from main and from threads.
  * 
  * example: kos_CreateThread(  50, "Thread 1", thread1Entry);
  * 
@@ -45,6 +133,26 @@ extern
 uint32_t kos_CreateThread( uint8_t pri, const char* pszName, KOS_STK *stack, uint32_t stk_size, threadfunc_t *pThreadFunc, void *pVoid);
 
 
+/** 
+ * Adds a thread function to the schedular with options.
+ * 
+ * Same as kos_CreateThread with flags. KOS_THREAD_TRUSTED starts the
+ * thread in SYS mode instead of USER mode. Kernel and driver calls from
+ * a trusted thread are made directly, with IRQ disabled, instead of
+ * trapping through the SWI, so they run on the thread's own stack.
+ * Size the stack for that. Only use it for threads that can be trusted
+ * with the whole machine.
+ * 
+ * @param pri is the priority of the thread
+ * @param pszName is the name of the thread
+ * @param pFunc the thread function
+ * @param flags is a combination of KOS_THREAD_xxx
+ * @return error code
+ */
+extern
+uint32_t kos_CreateThreadEx( uint8_t pri, const char* pszName, KOS_STK *stack, uint32_t stk_size, threadfunc_t *pThreadFunc, void *pVoid, uint32_t flags);
+
+
 /** 
  * Start the OS
  * 
@@ -56,5 +164,97 @@ extern
 uint32_t kos_StartOS(void);
 
 
+/** 
+ * Put the calling thread to sleep.
+ * 
+ * The thread leaves the ready list and is made ready again after the
+ * given number of ticks. A sleep of 0 ticks is the same as kos_Yield().
+ * Not for ISRs.
+ * 
+ * @param ticks is the number of ticks to sleep
+ * @return error code
+ */
+extern
+uint32_t kos_Sleep(uint32_t ticks);
+
+
+/** 
+ * The calling thread.
+ * 
+ * @return the calling thread's TCB, 0 before kos_StartOS
+ */
+extern
+threadTCB_t *kos_ThreadSelf(void);
+
+
+/** 
+ * Ticks since kos_StartOS.
+ * 
+ * Wraps after 2^32 ticks, so compare times by subtracting them.
+ * 
+ * @return the tick count
+ */
+extern
+uint32_t kos_TickCount(void);
+
+
+/** 
+ * Give up the rest of the time slice.
+ * 
+ * The calling thread moves to the back of its priority round. Returns
+ * at once if no other thread of the same priority is ready.
+ */
+extern
+void kos_Yield(void);
+
+
+#if KOS_USE_HOOKS
+
+/** 
+ * Register the switch-out hook.
+ * 
+ * Called from the switch path (the tick or a pended switch at the end
+ * of a SWI), with interrupts disabled, just before kos_threadCurr
+ * changes. Keep it short, it runs inside the kernel.
+ * Pass 0 to remove the hook.
+ * 
+ * @param pHook is the hook, called with the old and new TCB
+ */
+extern
+void kos_SetSwitchOutHook(kosSwitchHook_t *pHook);
+
+
+/** 
+ * Register the switch-in hook.
+ * 
+ * Called from the switch path, with interrupts disabled, just after
+ * kos_threadCurr has changed to the new thread. Pass 0 to remove the hook.
+ * 
+ * @param pHook is the hook, called with the old and new TCB
+ */
+extern
+void kos_SetSwitchInHook(kosSwitchHook_t *pHook);
+
+
+/** 
+ * Register the thread-create hook.
+ * 
+ * Called by kos_CreateThread once the new TCB is initialized and on the
+ * ready list. Pass 0 to remove the hook.
+ * 
+ * @param pHook is the hook, called with the new TCB
+ */
+extern
+void kos_SetCreateHook(kosCreateHook_t *pHook);
+
+#else
+
+#define kos_SetSwitchOutHook(pHook)
+#define kos_SetSwitchInHook(pHook)
+#define kos_SetCreateHook(pHook)
+
+#endif
+
+
 
 #endif /*OS_CORE_H_*/
@@ -0,0 +1,132 @@
+/** 
+ * 
+ * \file os_event.h
+ * Event flag groups
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_EVENT_H_
+#define OS_EVENT_H_
+
+
+// kos_EventWait options
+#define KOS_EVENT_ANY           0x00    // wake when any bit of the mask is set
+#define KOS_EVENT_ALL           0x01    // wake when every bit of the mask is set
+#define KOS_EVENT_CLEAR         0x02    // clear the mask bits on wake
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Group of 32 event flags, allocated by the caller and set up with kos_EventCreate
+typedef struct kosEvent_t {
+	uint32_t flags;
+	uint32_t isrFlags;			// set by kos_EventSetFromISR, merged when the post is drained
+	kosWaitList_t waitList;		// threads blocked in kos_EventWait
+	struct kosWaitObj_t *pMulti;	// kos_WaitMultiple callers, see os_multi.h
+}kosEvent_t;
+
+
+/** 
+ * Create an event flag group.
+ * 
+ * Initializes a kosEvent_t, usually a static one. Does not enter the
+ * kernel, so do it before any thread uses the group.
+ * 
+ * @param pEvent is the event flag group
+ * @param flags is the initial value of the flags
+ * @return error code
+ */
+extern
+uint32_t kos_EventCreate(kosEvent_t *pEvent, uint32_t flags);
+
+
+/** 
+ * Delete an event flag group.
+ * 
+ * Every thread blocked on the group wakes with OS_ERR_DELETED.
+ * 
+ * @param pEvent is the event flag group
+ * @return error code
+ */
+extern
+uint32_t kos_EventDelete(kosEvent_t *pEvent);
+
+
+/** 
+ * Wait for event flags.
+ * 
+ * Returns at once if the flags already match, otherwise the calling
+ * thread blocks until kos_EventSet makes them match or the timeout runs
+ * out. With KOS_EVENT_ANY any bit of mask is enough, with KOS_EVENT_ALL
+ * every bit of mask must be set. KOS_EVENT_CLEAR clears the mask bits
+ * once the wait is satisfied. Every waiter satisfied by the same
+ * kos_EventSet sees the bits before they are cleared. Not for ISRs.
+ * 
+ * @param pEvent is the event flag group
+ * @param mask is the bits to wait for
+ * @param opts is KOS_EVENT_ANY or KOS_EVENT_ALL, optionally with KOS_EVENT_CLEAR
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @param pFlags returns the flags that satisfied the wait, before any clear. Can be 0.
+ * @return error code, OS_ERR_TIMEOUT if the flags did not match in time
+ */
+extern
+uint32_t kos_EventWait(kosEvent_t *pEvent, uint32_t mask, uint32_t opts, uint32_t timeout, uint32_t *pFlags);
+
+
+/** 
+ * Set event flags.
+ * 
+ * Wakes every waiter whose wait the new flags satisfy.
+ * 
+ * @param pEvent is the event flag group
+ * @param bits is the bits to set
+ * @return error code
+ */
+extern
+uint32_t kos_EventSet(kosEvent_t *pEvent, uint32_t bits);
+
+
+/** 
+ * Set event flags from an ISR.
+ * 
+ * The bits are merged into the group when the kernel drains the post
+ * queue, which is as soon as the ISRs have returned. If the post queue
+ * is full they are still merged, by the next kos_EventSet or
+ * kos_EventWait on the group. A kos_EventClear drops those it clears.
+ * 
+ * @param pEvent is the event flag group
+ * @param bits is the bits to set
+ * @return error code, OS_ERR_POST_FULL if the post queue is full and
+ *   waiters wake late
+ */
+extern KOS_RAMFUNC
+uint32_t kos_EventSetFromISR(kosEvent_t *pEvent, uint32_t bits);
+
+
+/** 
+ * Clear event flags.
+ * 
+ * Never wakes a thread, so it can be called from ISRs as well.
+ * 
+ * @param pEvent is the event flag group
+ * @param bits is the bits to clear
+ * @return error code
+ */
+extern
+uint32_t kos_EventClear(kosEvent_t *pEvent, uint32_t bits);
+
+
+/** 
+ * Read the event flags.
+ * 
+ * @param pEvent is the event flag group
+ * @return the flags, they may change as soon as they are read
+ */
+extern
+uint32_t kos_EventPeek(kosEvent_t *pEvent);
+
+
+#endif /*OS_EVENT_H_*/
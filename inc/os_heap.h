@@ -0,0 +1,92 @@
+/** 
+ * 
+ * \file os_heap.h
+ * Heap
+ *
+ * A two-level segregated fit (TLSF) allocator over the RAM from
+ * __heap_start to __heap_end, which the linker script puts after the
+ * mode stacks. kos_Malloc and kos_Free take a bounded time whatever the
+ * state of the heap, and a request is never served from a block more
+ * than about 1/KOS_HEAP_SL_COUNT larger than needed.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_HEAP_H_
+#define OS_HEAP_H_
+
+
+// Second level lists per power of two, as log2. More lists waste less
+// of each block but cost 4 bytes of RAM each per power of two.
+#ifndef KOS_HEAP_SL_LOG2
+#define KOS_HEAP_SL_LOG2        3
+#endif
+#define KOS_HEAP_SL_COUNT       (1 << KOS_HEAP_SL_LOG2)
+
+// Largest block, as log2. The LPC2378 has 32k of RAM.
+#ifndef KOS_HEAP_FL_MAX
+#define KOS_HEAP_FL_MAX         15
+#endif
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Heap statistics, from kos_HeapStats
+typedef struct kosHeapStats_t {
+	uint32_t size;				// bytes the heap manages
+	uint32_t used;				// bytes in allocated blocks, headers included
+	uint32_t maxUsed;			// most bytes ever used at once
+	uint32_t allocs;			// kos_Malloc calls that succeeded
+	uint32_t frees;				// kos_Free calls
+	uint32_t fails;				// kos_Malloc calls that returned 0
+}kosHeapStats_t;
+
+
+/** 
+ * Set up the heap.
+ * 
+ * Call once, after kos_InitOS and before any thread uses the heap.
+ * 
+ * @return error code
+ */
+extern
+uint32_t kos_HeapInit(void);
+
+
+/** 
+ * Allocate memory.
+ * 
+ * The memory is word aligned and not cleared. Not for ISRs.
+ * 
+ * @param size is the number of bytes
+ * @return the memory, 0 if there is no free block big enough
+ */
+extern
+void *kos_Malloc(uint32_t size);
+
+
+/** 
+ * Free memory from kos_Malloc.
+ * 
+ * Not for ISRs.
+ * 
+ * @param p is the memory, 0 is ignored
+ * @return error code
+ */
+extern
+uint32_t kos_Free(void *p);
+
+
+/** 
+ * Read the heap statistics.
+ * 
+ * @param pStats gets a copy of them
+ * @return error code
+ */
+extern
+uint32_t kos_HeapStats(kosHeapStats_t *pStats);
+
+
+#endif /*OS_HEAP_H_*/
@@ -0,0 +1,526 @@
+/** 
+ * 
+ * \file os_kernel.h
+ * Kernel internals shared by the kos modules. Not for use by threads.
+ *
+ * Everything here runs inside the kernel: from a SWI service, which is
+ * entered with IRQ disabled, from the tick or from a request drained
+ * out of the post queue. No further locking is needed.
+ *
+ * The tick and switch path is KOS_RAMFUNC. Anything it calls must be
+ * KOS_RAMFUNC too.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_KERNEL_H_
+#define OS_KERNEL_H_
+
+
+// Saved context frame, threadTCB_t.stack points at the saved CPSR
+// [0] CPSR, [1] R0 ... [15] R14, [16] PC
+#define KOS_FRAME_CPSR      0
+#define KOS_FRAME_R0        1
+
+// threadTCB_t notifyState bits
+#define KOS_NOTIFY_STATE_PENDING    0x01    // kos_Notify has set notifyValue
+#define KOS_NOTIFY_STATE_WAITING    0x02    // blocked in kos_NotifyWait
+
+//--------------------------------------------------------------
+// typedefs
+
+struct kosQueue_t;
+
+	// kos_CreateThread arguments, too many to pass in registers
+typedef struct threadCreateArgs_t {
+	uint8_t pri;
+	const char *pszName;
+	KOS_STK *stack;
+	uint32_t stk_size;
+	threadfunc_t *pThreadFunc;
+	void *pVoid;
+	uint32_t flags;
+}threadCreateArgs_t;
+
+	// kos_EventWait arguments, pointed to by pWaitData while the thread waits
+typedef struct eventWaitArgs_t {
+	struct kosEvent_t *pEvent;
+	uint32_t mask;
+	uint32_t opts;
+	uint32_t timeout;
+	uint32_t *pFlags;
+}eventWaitArgs_t;
+
+	// kos_StreamRead and kos_StreamWrite arguments, pointed to by pWaitData while the thread waits
+typedef struct streamArgs_t {
+	struct kosStream_t *pStream;
+	uint8_t *pData;
+	uint32_t size;
+	uint32_t timeout;
+	uint32_t done;			// bytes moved so far, updated by the kernel while the thread waits
+}streamArgs_t;
+
+	// kos_WaitMultiple arguments, pointed to by pWaitData and by each object's node while the thread waits
+typedef struct multiWaitArgs_t {
+	struct kosWaitObj_t *pObjs;
+	uint32_t n;
+	uint32_t mode;
+	uint32_t timeout;
+	uint32_t index;			// object that fired, set by the kernel
+	threadTCB_t *pThread;	// the waiter
+}multiWaitArgs_t;
+
+//--------------------------------------------------------------
+// kernel variables
+
+extern threadTCB_t *kos_threadCurr;
+
+extern threadTCB_t *kos_threadList[KOS_MAX_PRIORITIES];
+
+extern volatile uint32_t kos_switchPending;
+
+//--------------------------------------------------------------
+// kernel functions
+
+/** 
+ * Add a thread to the back of its priority round.
+ * 
+ * Pends a switch if the thread has a higher priority than kos_threadCurr.
+ * 
+ * @param pThread is the thread to make ready
+ */
+extern KOS_RAMFUNC
+void kos_ReadyInsert(threadTCB_t *pThread);
+
+
+/** 
+ * Take a thread off its priority round.
+ * 
+ * Pends a switch if the thread is kos_threadCurr.
+ * 
+ * @param pThread is the thread to remove
+ */
+extern KOS_RAMFUNC
+void kos_ReadyRemove(threadTCB_t *pThread);
+
+
+/** 
+ * Put a thread on the delay list.
+ * 
+ * The thread must already be off the ready list. kos_TimerTick wakes
+ * it with kos_ThreadWake once the ticks have run out.
+ * 
+ * @param pThread is the thread to delay
+ * @param ticks is the number of ticks, must not be 0
+ */
+extern
+void kos_DelayInsert(threadTCB_t *pThread, uint32_t ticks);
+
+
+/** 
+ * Take a thread off the delay list.
+ * 
+ * @param pThread is the thread to remove
+ */
+extern KOS_RAMFUNC
+void kos_DelayRemove(threadTCB_t *pThread);
+
+
+/** 
+ * Make a waiting thread ready again.
+ * 
+ * Takes the thread off the delay list and its wait list, if it is on
+ * them, and sets the value returned by the SWI the thread is blocked in.
+ * The wait list's owner drops back to what the other waiters lend it.
+ * 
+ * @param pThread is the thread to wake
+ * @param result is returned to the thread
+ */
+extern KOS_RAMFUNC
+void kos_ThreadWake(threadTCB_t *pThread, uint32_t result);
+
+
+/** 
+ * Initialize a wait list with no waiters and no owner.
+ * 
+ * @param pList is the kernel object's wait list
+ */
+extern
+void kos_WaitListInit(kosWaitList_t *pList);
+
+
+/** 
+ * Put a thread on a wait list.
+ * 
+ * The list is kept in priority order. A thread goes behind the waiters
+ * of the same priority, so equal priorities wake first in, first out.
+ * 
+ * @param pList is the kernel object's wait list
+ * @param pThread is the thread, already off the ready list
+ */
+extern KOS_RAMFUNC
+void kos_WaitInsert(kosWaitList_t *pList, threadTCB_t *pThread);
+
+
+/** 
+ * Take a thread off the wait list it is blocked on.
+ * 
+ * @param pThread is the thread to remove
+ */
+extern KOS_RAMFUNC
+void kos_WaitRemove(threadTCB_t *pThread);
+
+
+/** 
+ * Block kos_threadCurr on a kernel object.
+ * 
+ * Moves the thread from the ready list to pList and, unless timeout is
+ * KOS_WAIT_FOREVER, onto the delay list. The switch happens at the end
+ * of the SWI. The thread's SWI returns the result passed to
+ * kos_ThreadWake, or OS_ERR_TIMEOUT if the tick wakes it first.
+ * If the object has an owner, the owner (and the owner of whatever it
+ * is blocked on in turn) is raised to the thread's priority.
+ * 
+ * @param pList is the kernel object's wait list
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return the service's return value, OS_ERR_TIMEOUT at once for KOS_NO_WAIT
+ */
+extern
+uint32_t kos_WaitBlock(kosWaitList_t *pList, uint32_t timeout);
+
+
+/** 
+ * Wake the highest priority thread on a wait list.
+ * 
+ * @param pList is the kernel object's wait list
+ * @param result is returned to the thread
+ * @return the thread woken, 0 if the list was empty
+ */
+extern
+threadTCB_t *kos_WaitWakeOne(kosWaitList_t *pList, uint32_t result);
+
+
+/** 
+ * Wake every thread on a wait list.
+ * 
+ * @param pList is the kernel object's wait list
+ * @param result is returned to the threads
+ */
+extern
+void kos_WaitWakeAll(kosWaitList_t *pList, uint32_t result);
+
+
+/** 
+ * Move a blocked thread to another wait list.
+ * 
+ * Cancels the thread's timeout and lends its priority to the new
+ * list's owner. The thread stays blocked.
+ * 
+ * @param pThread is the thread, blocked on a wait list
+ * @param pList is the wait list to move it to
+ */
+extern
+void kos_WaitRequeue(threadTCB_t *pThread, kosWaitList_t *pList);
+
+
+/** 
+ * Move blocked threads to another wait list in one pass.
+ * 
+ * Both lists are in priority order, so they are merged in a single walk
+ * of each. The threads moved keep waiting like kos_WaitRequeue leaves
+ * them, and the new list's owner inherits the highest priority once.
+ * 
+ * @param pFrom is the wait list to move threads from
+ * @param pTo is the wait list to move them to
+ * @param pWaitData if not 0 only threads with this pWaitData move
+ */
+extern
+void kos_WaitSplice(kosWaitList_t *pFrom, kosWaitList_t *pTo, void *pWaitData);
+
+
+/** 
+ * Take event flags for a wait they already satisfy.
+ * 
+ * Copies the flags to pFlags and clears mask with KOS_EVENT_CLEAR, as
+ * kos_EventWait does. Wakes nobody and does not run kos_MultiFire, so
+ * kos_MultiFire can use it.
+ * 
+ * @param pEvent is the event flag group
+ * @param mask is the bits waited for
+ * @param opts is KOS_EVENT_xxx
+ * @param pFlags if not 0 gets the flags
+ */
+extern
+void kos_EventTake(struct kosEvent_t *pEvent, uint32_t mask, uint32_t opts, uint32_t *pFlags);
+
+
+/** 
+ * Take the item at the front of a queue, it must not be empty.
+ * 
+ * Moves the first blocked sender's item into the freed slot, as
+ * kos_QueueReceive does. Does not run kos_MultiFire, so kos_MultiFire
+ * can use it.
+ * 
+ * @param pQueue is the queue
+ * @param pItem gets the item
+ */
+extern
+void kos_QueueTake(struct kosQueue_t *pQueue, void *pItem);
+
+
+/** 
+ * Serve the kos_WaitMultiple callers linked to an object.
+ * 
+ * Called by the object after it has served its own waiters, while it
+ * still has something to give. Wakes each caller it can satisfy, in
+ * turn, until the object runs dry.
+ * 
+ * @param ppList is the object's pMulti
+ */
+extern
+void kos_MultiFire(struct kosWaitObj_t **ppList);
+
+
+/** 
+ * Unlink the kos_WaitMultiple callers from an object being deleted.
+ * 
+ * They wake with OS_ERR_DELETED and the index of the object.
+ * 
+ * @param ppList is the object's pMulti
+ */
+extern
+void kos_MultiDelete(struct kosWaitObj_t **ppList);
+
+
+/** 
+ * Change the running priority of a thread.
+ * 
+ * Moves the thread to the new priority round if it is ready, or to its
+ * new place in the wait list if it is blocked. basePri is not changed.
+ * kos_threadCurr goes to the head of its new round, so it keeps the
+ * rest of its time slice.
+ * 
+ * @param pThread is the thread
+ * @param pri is the new running priority
+ */
+extern KOS_RAMFUNC
+void kos_ThreadSetPri(threadTCB_t *pThread, uint32_t pri);
+
+
+/** 
+ * Make a thread the owner of a kernel object.
+ * 
+ * Threads already waiting on the object lend it their priority.
+ * 
+ * @param pList is the kernel object's wait list
+ * @param pThread is the new owner
+ */
+extern
+void kos_OwnerSet(kosWaitList_t *pList, threadTCB_t *pThread);
+
+
+/** 
+ * Release the owner of a kernel object.
+ * 
+ * The old owner drops back to its base priority, or to the highest
+ * waiter on the other objects it still owns.
+ * 
+ * @param pList is the kernel object's wait list
+ */
+extern
+void kos_OwnerClear(kosWaitList_t *pList);
+
+/** 
+ * Copy a block of memory.
+ * 
+ * Moves words, four at a time, when both pointers have the same
+ * alignment. Only the bytes up to the first word boundary and the 1-3
+ * byte tail go one at a time. Pointers of different alignment fall back
+ * to bytes. Lives in RAM so ISR paths can use it, they cannot reach
+ * memcpy in flash with a BL.
+ * 
+ * @param pDst is the destination
+ * @param pSrc is the source, must not overlap pDst
+ * @param size is the number of bytes
+ */
+extern KOS_RAMFUNC
+void kos_MemCopy(void *pDst, const void *pSrc, uint32_t size);
+
+//--------------------------------------------------------------
+// kernel services, called from the SWI dispatch table
+
+// kernel objects, defined in their own headers
+struct kosSem_t;
+struct kosMutex_t;
+struct kosEvent_t;
+struct kosQueue_t;
+struct kosBufPool_t;
+struct kosBuf_t;
+struct kosStream_t;
+struct kosRwLock_t;
+struct kosCond_t;
+struct kosBarrier_t;
+struct kosWaitObj_t;
+struct kosWorkQueue_t;
+struct kosWork_t;
+struct kosTimer_t;
+struct kosPool_t;
+struct kosHeapStats_t;
+
+extern
+uint32_t kos_svcCreateThread(threadCreateArgs_t *pArgs);
+
+extern
+uint32_t kos_svcSleep(uint32_t ticks);
+
+extern
+uint32_t kos_svcYield(uint32_t result);
+
+extern
+uint32_t kos_svcSwitch(uint32_t result);
+
+extern
+uint32_t kos_svcSemWait(struct kosSem_t *pSem, uint32_t timeout);
+
+extern
+uint32_t kos_svcSemSignal(struct kosSem_t *pSem);
+
+extern
+uint32_t kos_svcSemDelete(struct kosSem_t *pSem);
+
+extern
+uint32_t kos_svcMutexLock(struct kosMutex_t *pMutex, uint32_t timeout);
+
+extern
+uint32_t kos_svcMutexUnlock(struct kosMutex_t *pMutex);
+
+extern
+uint32_t kos_svcMutexDelete(struct kosMutex_t *pMutex);
+
+extern
+uint32_t kos_svcEventWait(eventWaitArgs_t *pArgs);
+
+extern
+uint32_t kos_svcEventSet(struct kosEvent_t *pEvent, uint32_t bits);
+
+extern
+uint32_t kos_svcEventClear(struct kosEvent_t *pEvent, uint32_t bits);
+
+extern
+uint32_t kos_svcEventDelete(struct kosEvent_t *pEvent);
+
+extern
+uint32_t kos_svcQueueSend(struct kosQueue_t *pQueue, const void *pItem, uint32_t timeout);
+
+extern
+uint32_t kos_svcQueueReceive(struct kosQueue_t *pQueue, void *pItem, uint32_t timeout);
+
+extern
+uint32_t kos_svcQueueDelete(struct kosQueue_t *pQueue);
+
+extern
+uint32_t kos_svcBufAlloc(struct kosBufPool_t *pPool, struct kosBuf_t **ppBuf, uint32_t timeout);
+
+extern
+uint32_t kos_svcBufAddRef(struct kosBuf_t *pBuf);
+
+extern
+uint32_t kos_svcBufRelease(struct kosBuf_t *pBuf);
+
+extern
+uint32_t kos_svcNotify(threadTCB_t *pThread, uint32_t value, uint32_t action);
+
+extern
+uint32_t kos_svcNotifyWait(uint32_t timeout, uint32_t *pValue);
+
+extern
+uint32_t kos_svcStreamWrite(streamArgs_t *pArgs);
+
+extern
+uint32_t kos_svcStreamRead(streamArgs_t *pArgs);
+
+extern
+uint32_t kos_svcRwReadLock(struct kosRwLock_t *pLock, uint32_t timeout);
+
+extern
+uint32_t kos_svcRwReadUnlock(struct kosRwLock_t *pLock);
+
+extern
+uint32_t kos_svcRwWriteLock(struct kosRwLock_t *pLock, uint32_t timeout);
+
+extern
+uint32_t kos_svcRwWriteUnlock(struct kosRwLock_t *pLock);
+
+extern
+uint32_t kos_svcRwDelete(struct kosRwLock_t *pLock);
+
+extern
+uint32_t kos_svcCondWait(struct kosCond_t *pCond, struct kosMutex_t *pMutex, uint32_t timeout);
+
+extern
+uint32_t kos_svcCondSignal(struct kosCond_t *pCond);
+
+extern
+uint32_t kos_svcCondBroadcast(struct kosCond_t *pCond);
+
+extern
+uint32_t kos_svcCondDelete(struct kosCond_t *pCond);
+
+extern
+uint32_t kos_svcBarrierWait(struct kosBarrier_t *pBarrier, uint32_t timeout);
+
+extern
+uint32_t kos_svcBarrierDelete(struct kosBarrier_t *pBarrier);
+
+extern
+uint32_t kos_svcWaitMultiple(multiWaitArgs_t *pArgs);
+
+extern
+uint32_t kos_svcWaitMultipleCancel(multiWaitArgs_t *pArgs);
+
+extern
+uint32_t kos_svcWorkSubmit(struct kosWorkQueue_t *pQueue, struct kosWork_t *pWork);
+
+extern
+uint32_t kos_svcWorkTake(struct kosWorkQueue_t *pQueue, struct kosWork_t **ppWork);
+
+extern
+uint32_t kos_svcTimerStart(struct kosTimer_t *pTimer, uint32_t ticks, uint32_t period);
+
+extern
+uint32_t kos_svcTimerStop(struct kosTimer_t *pTimer);
+
+extern
+uint32_t kos_svcTimerNext(void (**ppFunc)(void *pArg), void **ppArg);
+
+extern
+uint32_t kos_svcAtomicCas(volatile uint32_t *p, uint32_t expected, uint32_t desired);
+
+extern
+uint32_t kos_svcAtomicAdd(volatile uint32_t *p, uint32_t value);
+
+extern
+uint32_t kos_svcAtomicSetBits(volatile uint32_t *p, uint32_t bits);
+
+extern
+uint32_t kos_svcAtomicClearBits(volatile uint32_t *p, uint32_t bits);
+
+extern
+uint32_t kos_svcPoolAlloc(struct kosPool_t *pPool, void **ppBlock, uint32_t timeout);
+
+extern
+uint32_t kos_svcPoolFree(struct kosPool_t *pPool, void *pBlock);
+
+extern
+void *kos_svcHeapAlloc(uint32_t size);
+
+extern
+uint32_t kos_svcHeapFree(void *p);
+
+extern
+uint32_t kos_svcHeapStats(struct kosHeapStats_t *pStats);
+
+
+#endif /*OS_KERNEL_H_*/
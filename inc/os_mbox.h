@@ -0,0 +1,198 @@
+/** 
+ * 
+ * \file os_mbox.h
+ * Zero-copy mailboxes of reference counted buffers
+ *
+ * A buffer pool hands out fixed-size buffers. A mailbox is a message
+ * queue of buffer pointers, so only the pointer is copied however large
+ * the buffer. Every holder of a buffer owns one reference: kos_BufAlloc
+ * returns the first, each kos_MboxPost adds one for the receiver, and
+ * kos_BufRelease drops one. The last release returns the buffer to its
+ * pool. To fan out, post the same buffer to several mailboxes and then
+ * release the producer's reference.
+ *
+ * Requires os_queue.h.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_MBOX_H_
+#define OS_MBOX_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Buffer header, the data follows it
+typedef struct kosBuf_t {
+	struct kosBuf_t *pNext;			// free list link
+	struct kosBufPool_t *pPool;		// pool the buffer goes back to
+	uint32_t refCount;
+	uint32_t length;				// bytes of data in use, up to the producer
+	uint32_t tag;					// up to the producer, kos_BusPublish puts the topic here
+}kosBuf_t;
+
+	// Pool of fixed-size buffers, set up with kos_BufPoolCreate
+typedef struct kosBufPool_t {
+	kosBuf_t *pFree;
+	uint32_t bufSize;				// data bytes per buffer
+	kosWaitList_t waitList;			// threads blocked in kos_BufAlloc
+}kosBufPool_t;
+
+	// Mailbox of kosBuf_t pointers, set up with kos_MboxCreate
+typedef struct kosMbox_t {
+	kosQueue_t queue;
+}kosMbox_t;
+
+
+// Words of storage for a pool, e.g.
+// static uint32_t framePool[KOS_BUF_POOL_WORDS(512, 4)];
+#define KOS_BUF_POOL_WORDS(bufSize, bufCount)   (((sizeof(kosBuf_t)+KOS_QUEUE_SLOT_SIZE(bufSize))/4)*(bufCount))
+
+// Words of storage for a mailbox of msgCount buffers
+#define KOS_MBOX_BUFFER_WORDS(msgCount)         KOS_QUEUE_BUFFER_WORDS(sizeof(kosBuf_t *), (msgCount))
+
+// Data of a buffer, word aligned
+#define KOS_BUF_DATA(pBuf)                      ((void *)((kosBuf_t *)(pBuf)+1))
+
+
+/** 
+ * Create a buffer pool.
+ * 
+ * Carves the storage into bufCount buffers of bufSize data bytes. Does
+ * not enter the kernel, so do it before any thread uses the pool.
+ * 
+ * @param pPool is the pool
+ * @param pStorage is KOS_BUF_POOL_WORDS(bufSize, bufCount) words
+ * @param bufSize is the data size of a buffer in bytes
+ * @param bufCount is the number of buffers
+ * @return error code
+ */
+extern
+uint32_t kos_BufPoolCreate(kosBufPool_t *pPool, uint32_t *pStorage, uint32_t bufSize, uint32_t bufCount);
+
+
+/** 
+ * Take a buffer from a pool.
+ * 
+ * The buffer comes with one reference, owned by the caller. If the pool
+ * is empty the caller blocks until a buffer is released or the timeout
+ * runs out. Not for ISRs, use kos_BufAllocFromISR.
+ * 
+ * @param pPool is the pool
+ * @param ppBuf returns the buffer, 0 if none was taken
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if no buffer was free in time
+ */
+extern
+uint32_t kos_BufAlloc(kosBufPool_t *pPool, kosBuf_t **ppBuf, uint32_t timeout);
+
+
+/** 
+ * Take a buffer from a pool in an ISR.
+ * 
+ * @param pPool is the pool
+ * @return the buffer with one reference, 0 if the pool is empty
+ */
+extern KOS_RAMFUNC
+kosBuf_t *kos_BufAllocFromISR(kosBufPool_t *pPool);
+
+
+/** 
+ * Add a reference to a buffer.
+ * 
+ * @param pBuf is the buffer
+ * @return error code
+ */
+extern
+uint32_t kos_BufAddRef(kosBuf_t *pBuf);
+
+
+/** 
+ * Drop a reference to a buffer.
+ * 
+ * The last release returns the buffer to its pool, or hands it
+ * straight to the highest priority thread waiting in kos_BufAlloc.
+ * 
+ * @param pBuf is the buffer
+ * @return error code
+ */
+extern
+uint32_t kos_BufRelease(kosBuf_t *pBuf);
+
+
+/** 
+ * Drop a reference to a buffer in an ISR.
+ * 
+ * OS_ERR_POST_FULL means the reference is dropped but waking a thread
+ * waiting in kos_BufAlloc is deferred, see kos_PostFromISR.
+ * 
+ * @param pBuf is the buffer
+ * @return error code, OS_ERR_POST_FULL if the wake was deferred
+ */
+extern KOS_RAMFUNC
+uint32_t kos_BufReleaseFromISR(kosBuf_t *pBuf);
+
+
+/** 
+ * Create a mailbox.
+ * 
+ * @param pMbox is the mailbox
+ * @param pBuffer is KOS_MBOX_BUFFER_WORDS(msgCount) words
+ * @param msgCount is the number of buffers the mailbox holds
+ * @return error code
+ */
+extern
+uint32_t kos_MboxCreate(kosMbox_t *pMbox, uint32_t *pBuffer, uint32_t msgCount);
+
+
+/** 
+ * Post a buffer to a mailbox.
+ * 
+ * Adds a reference for the receiver. The caller keeps its own and must
+ * still release it. Blocks while the mailbox is full, as kos_QueueSend.
+ * If the post fails the added reference is dropped again.
+ * 
+ * @param pMbox is the mailbox
+ * @param pBuf is the buffer
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if the buffer was not posted
+ */
+extern
+uint32_t kos_MboxPost(kosMbox_t *pMbox, kosBuf_t *pBuf, uint32_t timeout);
+
+
+/** 
+ * Post a buffer to a mailbox from an ISR.
+ * 
+ * As kos_MboxPost, but never blocks. The ISR must hold a reference of
+ * its own, from kos_BufAllocFromISR, until it has posted the buffer.
+ * OS_ERR_POST_FULL means the buffer is posted but the receiver's wake
+ * is deferred, as kos_QueueSendFromISR.
+ * 
+ * @param pMbox is the mailbox
+ * @param pBuf is the buffer
+ * @return error code, OS_ERR_QUEUE_FULL if the mailbox is full
+ */
+extern KOS_RAMFUNC
+uint32_t kos_MboxPostFromISR(kosMbox_t *pMbox, kosBuf_t *pBuf);
+
+
+/** 
+ * Receive a buffer from a mailbox.
+ * 
+ * The caller owns the reference that came with the buffer and must
+ * release it when done. Blocks while the mailbox is empty.
+ * 
+ * @param pMbox is the mailbox
+ * @param ppBuf returns the buffer
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if no buffer was received
+ */
+extern
+uint32_t kos_MboxReceive(kosMbox_t *pMbox, kosBuf_t **ppBuf, uint32_t timeout);
+
+
+#endif /*OS_MBOX_H_*/
@@ -0,0 +1,69 @@
+/** 
+ * 
+ * \file os_multi.h
+ * Waiting on several kernel objects at once
+ *
+ * Requires the headers of the objects waited on.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_MULTI_H_
+#define OS_MULTI_H_
+
+
+// kosWaitObj_t types
+#define KOS_WAIT_OBJ_SEM        1       // take a count
+#define KOS_WAIT_OBJ_QUEUE      2       // receive an item into pData
+#define KOS_WAIT_OBJ_EVENT      3       // wait for mask with opts, the flags go to pData if not 0
+
+// kos_WaitMultiple modes
+#define KOS_WAIT_MULTI_ANY      0       // wake on the first object that fires
+#define KOS_WAIT_MULTI_ALL      1       // wake once every object can fire together
+
+//--------------------------------------------------------------
+// typedefs
+
+	// One object for kos_WaitMultiple. The caller sets the first five
+	// fields, the kernel links the entry into the object while it waits.
+typedef struct kosWaitObj_t {
+	uint32_t type;					// KOS_WAIT_OBJ_xxx
+	void *pObj;						// kosSem_t, kosQueue_t or kosEvent_t
+	void *pData;					// queue item buffer, or event flags out
+	uint32_t mask;					// event only
+	uint32_t opts;					// event only, KOS_EVENT_xxx
+	struct kosWaitObj_t *pNext;		// other callers waiting on the object
+	struct kosWaitObj_t *pPrev;
+	struct multiWaitArgs_t *pArgs;	// the call, 0 while not linked
+}kosWaitObj_t;
+
+
+/** 
+ * Wait on several semaphores, queues and event groups.
+ * 
+ * Each object is taken the way its own wait call would take it: a
+ * semaphore count, a queue item copied to pData, event flags cleared
+ * with KOS_EVENT_CLEAR. In KOS_WAIT_MULTI_ANY mode one object is taken
+ * and its index returned. In KOS_WAIT_MULTI_ALL mode they are all
+ * taken together once they all can be, and the index is n.
+ * 
+ * kos_WaitMultiple callers are served in priority order, but only after
+ * the object's own blocked threads, whatever their priority. A high
+ * priority thread that must not lose to them should wait on the object
+ * directly. List each object once. Not for ISRs.
+ * 
+ * @param pObjs is an array of n objects, it must stay valid during the call
+ * @param n is the number of objects
+ * @param mode is KOS_WAIT_MULTI_ANY or KOS_WAIT_MULTI_ALL
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @param pIndex if not 0 gets the index of the object that fired
+ * @return error code, OS_ERR_TIMEOUT if none fired in time,
+ *   OS_ERR_DELETED if the object at *pIndex was deleted
+ */
+extern
+uint32_t kos_WaitMultiple(kosWaitObj_t *pObjs, uint32_t n, uint32_t mode, uint32_t timeout, uint32_t *pIndex);
+
+
+#endif /*OS_MULTI_H_*/
@@ -0,0 +1,94 @@
+/** 
+ * 
+ * \file os_mutex.h
+ * Mutexes with priority inheritance
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_MUTEX_H_
+#define OS_MUTEX_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Mutex, allocated by the caller and set up with kos_MutexCreate
+typedef struct kosMutex_t {
+	uint32_t nesting;			// times the owner has locked it, 0 when free
+	kosWaitList_t waitList;		// waitList.pOwner is the owner
+}kosMutex_t;
+
+
+/** 
+ * Create a mutex.
+ * 
+ * Initializes a kosMutex_t, usually a static one, unlocked. Does not
+ * enter the kernel, so do it before any thread uses the mutex.
+ * 
+ * @param pMutex is the mutex
+ * @return error code
+ */
+extern
+uint32_t kos_MutexCreate(kosMutex_t *pMutex);
+
+
+/** 
+ * Delete a mutex.
+ * 
+ * Every thread blocked on the mutex wakes with OS_ERR_DELETED and the
+ * owner, if any, drops back to the priority it would have without it.
+ * 
+ * @param pMutex is the mutex
+ * @return error code
+ */
+extern
+uint32_t kos_MutexDelete(kosMutex_t *pMutex);
+
+
+/** 
+ * Lock a mutex.
+ * 
+ * The owner may lock it again, it must then unlock it as many times.
+ * If another thread owns it the caller blocks, and the owner runs at
+ * the caller's priority until it unlocks, if that is higher than its
+ * own. If the caller times out first the owner drops back to what the
+ * remaining waiters lend it. Waiters get the mutex highest priority
+ * first. Not for ISRs.
+ * 
+ * @param pMutex is the mutex
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if the mutex was not locked
+ */
+extern
+uint32_t kos_MutexLock(kosMutex_t *pMutex, uint32_t timeout);
+
+
+/** 
+ * Lock a mutex if it is free or already owned by the caller.
+ * 
+ * Same as kos_MutexLock(pMutex, KOS_NO_WAIT).
+ * 
+ * @param pMutex is the mutex
+ * @return error code, OS_ERR_TIMEOUT if another thread owns it
+ */
+extern
+uint32_t kos_MutexTryLock(kosMutex_t *pMutex);
+
+
+/** 
+ * Unlock a mutex.
+ * 
+ * The last unlock by the owner restores its priority and hands the
+ * mutex straight to the highest priority waiter.
+ * 
+ * @param pMutex is the mutex
+ * @return error code, OS_ERR_NOT_OWNER if the caller does not own it
+ */
+extern
+uint32_t kos_MutexUnlock(kosMutex_t *pMutex);
+
+
+#endif /*OS_MUTEX_H_*/
@@ -0,0 +1,71 @@
+/** 
+ * 
+ * \file os_notify.h
+ * Direct-to-thread notifications
+ *
+ * Every thread has a notification value in its TCB. It works as a
+ * light semaphore or event group with a single waiter, the thread
+ * itself, and needs no kernel object.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_NOTIFY_H_
+#define OS_NOTIFY_H_
+
+
+// kos_Notify actions
+#define KOS_NOTIFY_INCREMENT    0   // add one to the value, value is ignored
+#define KOS_NOTIFY_SET_BITS     1   // OR value into the value
+#define KOS_NOTIFY_OVERWRITE    2   // replace the value
+
+/** 
+ * Notify a thread.
+ * 
+ * Updates the thread's notification value and wakes it if it is
+ * blocked in kos_NotifyWait. A long call, so KOS_RAMFUNC code such as
+ * kos_RingWrite can reach the stub in flash.
+ * 
+ * @param pThread is the thread, see KOS_THREAD_HANDLE
+ * @param value is used as the action says
+ * @param action is KOS_NOTIFY_xxx
+ * @return error code
+ */
+extern __attribute__ ((long_call))
+uint32_t kos_Notify(threadTCB_t *pThread, uint32_t value, uint32_t action);
+
+
+/** 
+ * Notify a thread from an ISR.
+ * 
+ * The value is updated in the ISR. The kernel is only entered, through
+ * the post queue, if the thread is blocked in kos_NotifyWait.
+ * 
+ * @param pThread is the thread, see KOS_THREAD_HANDLE
+ * @param value is used as the action says
+ * @param action is KOS_NOTIFY_xxx
+ * @return error code
+ */
+extern KOS_RAMFUNC
+uint32_t kos_NotifyFromISR(threadTCB_t *pThread, uint32_t value, uint32_t action);
+
+
+/** 
+ * Wait for a notification.
+ * 
+ * Returns at once if the calling thread has been notified since its
+ * last wait, otherwise blocks until it is or the timeout runs out. The
+ * value is taken, so the next wait starts from 0. After increments it
+ * is the number of notifications. Not for ISRs.
+ * 
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @param pValue returns the notification value. Can be 0.
+ * @return error code, OS_ERR_TIMEOUT if the thread was not notified
+ */
+extern
+uint32_t kos_NotifyWait(uint32_t timeout, uint32_t *pValue);
+
+
+#endif /*OS_NOTIFY_H_*/
@@ -0,0 +1,123 @@
+/** 
+ * 
+ * \file os_pool.h
+ * Fixed-block memory pools
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_POOL_H_
+#define OS_POOL_H_
+
+
+// Set KOS_POOL_CHECK to 1 (e.g. -DKOS_POOL_CHECK=1 in UDEFS) to have
+// every free search the free list for the block, to catch any double
+// free. When 0 only a block freed twice in a row, or a free with none
+// allocated, is caught.
+#ifndef KOS_POOL_CHECK
+#define KOS_POOL_CHECK          0
+#endif
+
+// Blocks are a whole number of words, so they stay word aligned
+#define KOS_POOL_BLOCK_SIZE(blockSize)              (((blockSize)+3) & ~3)
+
+// Words of storage for a pool, e.g.
+// static uint32_t msgStorage[KOS_POOL_WORDS(sizeof(msg_t), 16)];
+#define KOS_POOL_WORDS(blockSize, blockCount)       ((KOS_POOL_BLOCK_SIZE(blockSize)/4)*(blockCount))
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Pool of fixed-size blocks, allocated by the caller and set up with
+	// kos_PoolCreate. The statistics may be read directly.
+typedef struct kosPool_t {
+	void *pFree;				// free blocks, each holds the next
+	uint8_t *pStart;			// storage, for checking frees
+	uint8_t *pEnd;
+	uint32_t blockSize;			// KOS_POOL_BLOCK_SIZE of the size asked for
+	uint32_t blockRecip;		// 2^32 / blockSize rounded up, to check frees without a divide
+	uint32_t blockCount;
+	uint32_t used;				// blocks allocated now
+	uint32_t maxUsed;			// most blocks ever allocated at once
+	uint32_t fails;				// allocations that found the pool empty
+	kosWaitList_t waitList;		// threads blocked in kos_PoolAlloc
+}kosPool_t;
+
+
+/** 
+ * Create a memory pool.
+ * 
+ * Carves the storage into blockCount blocks. Does not enter the
+ * kernel, so do it before any thread uses the pool.
+ * 
+ * @param pPool is the pool
+ * @param pStorage is KOS_POOL_WORDS(blockSize, blockCount) words
+ * @param blockSize is the size of a block in bytes
+ * @param blockCount is the number of blocks
+ * @return error code
+ */
+extern
+uint32_t kos_PoolCreate(kosPool_t *pPool, uint32_t *pStorage, uint32_t blockSize, uint32_t blockCount);
+
+
+/** 
+ * Allocate a block.
+ * 
+ * If the pool is empty the caller blocks until a block is freed or the
+ * timeout runs out. Not for ISRs, use kos_PoolAllocFromISR.
+ * 
+ * @param pPool is the pool
+ * @param ppBlock returns the block, 0 if none was allocated
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if no block was free in time
+ */
+extern
+uint32_t kos_PoolAlloc(kosPool_t *pPool, void **ppBlock, uint32_t timeout);
+
+
+/** 
+ * Allocate a block in an ISR.
+ * 
+ * @param pPool is the pool
+ * @return the block, 0 if the pool is empty
+ */
+extern KOS_RAMFUNC
+void *kos_PoolAllocFromISR(kosPool_t *pPool);
+
+
+/** 
+ * Free a block.
+ * 
+ * Hands it straight to the highest priority thread waiting in
+ * kos_PoolAlloc, if there is one.
+ * 
+ * @param pPool is the pool the block came from
+ * @param pBlock is the block
+ * @return error code, ERR_ARG if the block is not from the pool or is
+ *   already free
+ */
+extern
+uint32_t kos_PoolFree(kosPool_t *pPool, void *pBlock);
+
+
+/** 
+ * Free a block in an ISR.
+ * 
+ * The block goes back on the free list and a waiting allocator is
+ * woken through the post queue as soon as the ISRs have returned.
+ * OS_ERR_POST_FULL means the block is freed but the wake is deferred,
+ * so do not free it again. The next kos_PoolAlloc, kos_PoolFree or
+ * kos_PoolFreeFromISR on the pool hands it over.
+ * 
+ * @param pPool is the pool the block came from
+ * @param pBlock is the block
+ * @return error code, ERR_ARG if the block is not from the pool or is
+ *   already free, OS_ERR_POST_FULL if the wake was deferred
+ */
+extern KOS_RAMFUNC
+uint32_t kos_PoolFreeFromISR(kosPool_t *pPool, void *pBlock);
+
+
+#endif /*OS_POOL_H_*/
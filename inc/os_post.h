@@ -0,0 +1,64 @@
+/** 
+ * 
+ * \file os_post.h
+ * Deferred ISR-to-kernel post queue
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_POST_H_
+#define OS_POST_H_
+
+
+// Number of entries in the post queue, must be a power of two
+#define KOS_POST_QUEUE_LEN      16
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Deferred kernel request, run by the kernel when the queue is drained
+typedef void (kosPostFunc_t)(void *pArg);
+
+
+/** 
+ * Post a kernel request from an ISR.
+ * 
+ * ISRs must not touch kos_threadList or any other kernel object
+ * directly. Instead they post the request here and the kernel runs
+ * pFunc(pArg) when it drains the queue. Posting raises the kernel pend
+ * interrupt, which drains the queue as soon as the ISRs have returned,
+ * and TimerTickISR and a pended switch drain it too. Interrupts are
+ * masked only while the slot is claimed, so the cost in the ISR is a
+ * few instructions no matter what the request does. Must not be called
+ * from FIQ. Lives in RAM so it can be called from KOS_RAMFUNC ISRs.
+ * 
+ * A FromISR call that changes its object in the ISR (queues an item,
+ * frees a block, links a work item) and then posts only the wake keeps
+ * that change when the post fails. It returns OS_ERR_POST_FULL to say
+ * the wake is deferred, and the caller must not repeat the call. The
+ * object hands over what is stranded at its next kernel call, or the
+ * next time an ISR posts to it. A request that is the whole change,
+ * such as kos_SemSignalFromISR, is lost instead.
+ * 
+ * @param pFunc is the kernel request to run
+ * @param pArg is passed to pFunc
+ * @return error code, OS_ERR_POST_FULL if the queue is full
+ */
+extern KOS_RAMFUNC
+uint32_t kos_PostFromISR(kosPostFunc_t *pFunc, void *pArg);
+
+
+/** 
+ * Run every request waiting in the post queue.
+ * 
+ * Kernel only. Called with the scheduler locked out, either from the
+ * tick or from the switch path, so the requests can safely change the
+ * thread lists.
+ */
+extern KOS_RAMFUNC
+void kos_PostDrain(void);
+
+
+#endif /*OS_POST_H_*/
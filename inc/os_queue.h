@@ -0,0 +1,131 @@
+/** 
+ * 
+ * \file os_queue.h
+ * Message queues of fixed-size items
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_QUEUE_H_
+#define OS_QUEUE_H_
+
+
+// Items are stored a whole number of words apart, so they copy as words
+#define KOS_QUEUE_SLOT_SIZE(itemSize)               (((itemSize)+3) & ~3)
+
+// Words of storage for a queue, e.g.
+// static uint32_t rxBuffer[KOS_QUEUE_BUFFER_WORDS(sizeof(msg_t), 8)];
+#define KOS_QUEUE_BUFFER_WORDS(itemSize, itemCount) ((KOS_QUEUE_SLOT_SIZE(itemSize)/4)*(itemCount))
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Message queue, allocated by the caller and set up with kos_QueueCreate
+typedef struct kosQueue_t {
+	uint8_t *pBuffer;			// itemCount slots, word aligned
+	uint32_t itemSize;			// bytes copied per item
+	uint32_t slotSize;			// KOS_QUEUE_SLOT_SIZE(itemSize)
+	uint32_t bufSize;			// slotSize * itemCount
+	uint32_t itemCount;
+	uint32_t count;				// items in the queue
+	uint32_t head;				// offset of the slot written next
+	uint32_t tail;				// offset of the slot read next
+	kosWaitList_t sendList;		// threads blocked in kos_QueueSend, the queue is full
+	kosWaitList_t recvList;		// threads blocked in kos_QueueReceive, the queue is empty
+	struct kosWaitObj_t *pMulti;	// kos_WaitMultiple callers receiving, see os_multi.h
+}kosQueue_t;
+
+
+/** 
+ * Create a message queue.
+ * 
+ * Initializes a kosQueue_t, usually a static one, over storage from the
+ * caller. Does not enter the kernel, so do it before any thread uses
+ * the queue.
+ * 
+ * @param pQueue is the queue
+ * @param pBuffer is KOS_QUEUE_BUFFER_WORDS(itemSize, itemCount) words
+ * @param itemSize is the size of an item in bytes
+ * @param itemCount is the number of items the queue holds
+ * @return error code
+ */
+extern
+uint32_t kos_QueueCreate(kosQueue_t *pQueue, uint32_t *pBuffer, uint32_t itemSize, uint32_t itemCount);
+
+
+/** 
+ * Delete a message queue.
+ * 
+ * Every thread blocked on the queue wakes with OS_ERR_DELETED and the
+ * items in it are dropped.
+ * 
+ * @param pQueue is the queue
+ * @return error code
+ */
+extern
+uint32_t kos_QueueDelete(kosQueue_t *pQueue);
+
+
+/** 
+ * Send an item.
+ * 
+ * Copies itemSize bytes from pItem to the back of the queue. If a
+ * thread is waiting to receive, the item is copied straight into its
+ * buffer. If the queue is full the caller blocks until there is room or
+ * the timeout runs out. Not for ISRs, use kos_QueueSendFromISR.
+ * 
+ * @param pQueue is the queue
+ * @param pItem is the item to send
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if the item was not sent
+ */
+extern
+uint32_t kos_QueueSend(kosQueue_t *pQueue, const void *pItem, uint32_t timeout);
+
+
+/** 
+ * Send an item from an ISR.
+ * 
+ * Copies the item into the queue in the ISR and never blocks. A
+ * waiting receiver is woken through the post queue as soon as the ISRs
+ * have returned. OS_ERR_POST_FULL means the item is queued but the wake
+ * is deferred, so do not send it again. The next kos_QueueReceive or
+ * send on the queue hands it over.
+ * 
+ * @param pQueue is the queue
+ * @param pItem is the item to send
+ * @return error code, OS_ERR_QUEUE_FULL if there is no room
+ */
+extern KOS_RAMFUNC
+uint32_t kos_QueueSendFromISR(kosQueue_t *pQueue, const void *pItem);
+
+
+/** 
+ * Receive an item.
+ * 
+ * Copies the item at the front of the queue to pItem. If the queue is
+ * empty the caller blocks until an item is sent or the timeout runs
+ * out. Receivers are served highest priority first. Not for ISRs.
+ * 
+ * @param pQueue is the queue
+ * @param pItem is a buffer of itemSize bytes
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if no item was received
+ */
+extern
+uint32_t kos_QueueReceive(kosQueue_t *pQueue, void *pItem, uint32_t timeout);
+
+
+/** 
+ * Number of items in a queue.
+ * 
+ * @param pQueue is the queue
+ * @return the count, it may change as soon as it is read
+ */
+extern
+uint32_t kos_QueueCount(kosQueue_t *pQueue);
+
+
+#endif /*OS_QUEUE_H_*/
@@ -0,0 +1,104 @@
+/** 
+ * 
+ * \file os_ring.h
+ * Lock-free single producer, single consumer ring buffer
+ *
+ * For streaming bytes from an ISR to a thread, or between two threads,
+ * without masking interrupts or entering the kernel. The producer only
+ * writes head and the consumer only writes tail, so neither side needs
+ * a lock as long as there is exactly one of each.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_RING_H_
+#define OS_RING_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Ring buffer, allocated by the caller and set up with kos_RingCreate
+typedef struct kosRing_t {
+	volatile uint32_t head;			// bytes written, free running, producer only
+	volatile uint32_t tail;			// bytes read, free running, consumer only
+	uint32_t mask;					// size - 1
+	uint8_t *pBuffer;
+	threadTCB_t *pConsumer;			// thread in kos_RingWait
+	volatile uint32_t waiting;		// set while pConsumer waits for data
+}kosRing_t;
+
+
+/** 
+ * Create a ring buffer.
+ * 
+ * @param pRing is the ring buffer
+ * @param pBuffer is the storage
+ * @param size is the size of pBuffer in bytes, a power of two
+ * @return error code
+ */
+extern
+uint32_t kos_RingCreate(kosRing_t *pRing, uint8_t *pBuffer, uint32_t size);
+
+
+/** 
+ * Write to a ring buffer, producer side.
+ * 
+ * Copies as many bytes as there is room for, in at most two spans. If
+ * the consumer is blocked in kos_RingWait it is notified. Can be called
+ * from an ISR.
+ * 
+ * @param pRing is the ring buffer
+ * @param pData is the bytes to write
+ * @param size is the number of bytes
+ * @return the number of bytes written
+ */
+extern KOS_RAMFUNC
+uint32_t kos_RingWrite(kosRing_t *pRing, const void *pData, uint32_t size);
+
+
+/** 
+ * Read from a ring buffer, consumer side.
+ * 
+ * Copies as many bytes as are available, up to size, in at most two
+ * spans. Never blocks. Can be called from an ISR.
+ * 
+ * @param pRing is the ring buffer
+ * @param pData is the buffer to read into
+ * @param size is the size of pData in bytes
+ * @return the number of bytes read
+ */
+extern KOS_RAMFUNC
+uint32_t kos_RingRead(kosRing_t *pRing, void *pData, uint32_t size);
+
+
+/** 
+ * Wait for data in a ring buffer, consumer side.
+ * 
+ * Returns at once if the ring is not empty. Otherwise the calling
+ * thread blocks in kos_NotifyWait until the producer writes. This is
+ * the only call that enters the kernel, and the producer only does so
+ * while the consumer is waiting here. Uses the calling thread's
+ * notification value. Not for ISRs.
+ * 
+ * @param pRing is the ring buffer
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if the ring is still empty
+ */
+extern
+uint32_t kos_RingWait(kosRing_t *pRing, uint32_t timeout);
+
+
+/** 
+ * Bytes waiting in a ring buffer.
+ * 
+ * @param pRing is the ring buffer
+ * @return the count, exact for the consumer, a lower bound for the producer
+ */
+extern
+uint32_t kos_RingCount(kosRing_t *pRing);
+
+
+#endif /*OS_RING_H_*/
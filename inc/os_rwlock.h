@@ -0,0 +1,110 @@
+/** 
+ * 
+ * \file os_rwlock.h
+ * Reader-writer locks
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_RWLOCK_H_
+#define OS_RWLOCK_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Reader-writer lock, allocated by the caller and set up with kos_RwCreate
+typedef struct kosRwLock_t {
+	uint32_t readers;			// threads holding a read lock
+	kosWaitList_t writeList;	// writers blocked, pOwner is the writer holding the lock
+	kosWaitList_t readList;		// readers blocked, pOwner is the writer holding the lock
+}kosRwLock_t;
+
+
+/** 
+ * Create a reader-writer lock.
+ * 
+ * Does not enter the kernel, so do it before any thread uses the lock.
+ * 
+ * @param pLock is the lock
+ * @return error code
+ */
+extern
+uint32_t kos_RwCreate(kosRwLock_t *pLock);
+
+
+/** 
+ * Delete a reader-writer lock.
+ * 
+ * Every thread blocked on the lock wakes with OS_ERR_DELETED.
+ * 
+ * @param pLock is the lock
+ * @return error code
+ */
+extern
+uint32_t kos_RwDelete(kosRwLock_t *pLock);
+
+
+/** 
+ * Lock for reading.
+ * 
+ * Any number of threads can hold the read lock together. A reader
+ * blocks while a writer holds the lock or is waiting for it, so a
+ * stream of readers cannot starve a writer. The writer holding the
+ * lock runs at the priority of the highest blocked thread. Read locks
+ * do not nest with a write lock held by the same thread. Not for ISRs.
+ * 
+ * @param pLock is the lock
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if the lock was not taken
+ */
+extern
+uint32_t kos_RwReadLock(kosRwLock_t *pLock, uint32_t timeout);
+
+
+/** 
+ * Unlock a read lock.
+ * 
+ * The last reader out hands the lock to the first blocked writer.
+ * Read holders are only counted, not recorded, so the kernel cannot
+ * tell which thread holds a read lock. Only a thread that holds one
+ * may call this. A call from any other thread releases someone
+ * else's read lock.
+ * 
+ * @param pLock is the lock
+ * @return error code, OS_ERR_NOT_OWNER if no read lock is held
+ */
+extern
+uint32_t kos_RwReadUnlock(kosRwLock_t *pLock);
+
+
+/** 
+ * Lock for writing.
+ * 
+ * Blocks until no reader or other writer holds the lock. Not for ISRs.
+ * 
+ * @param pLock is the lock
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if the lock was not taken
+ */
+extern
+uint32_t kos_RwWriteLock(kosRwLock_t *pLock, uint32_t timeout);
+
+
+/** 
+ * Unlock a write lock.
+ * 
+ * Restores the writer's priority. The lock goes to the blocked readers
+ * together, or to the first blocked writer, whichever has the highest
+ * priority. A writer wins a tie.
+ * 
+ * @param pLock is the lock
+ * @return error code, OS_ERR_NOT_OWNER if the caller does not hold it
+ */
+extern
+uint32_t kos_RwWriteUnlock(kosRwLock_t *pLock);
+
+
+#endif /*OS_RWLOCK_H_*/
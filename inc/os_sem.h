@@ -0,0 +1,119 @@
+/** 
+ * 
+ * \file os_sem.h
+ * Counting semaphores
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_SEM_H_
+#define OS_SEM_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Counting semaphore, allocated by the caller and set up with kos_SemCreate
+typedef struct kosSem_t {
+	uint32_t count;
+	uint32_t maxCount;
+	kosWaitList_t waitList;		// threads blocked in kos_SemWait
+	struct kosWaitObj_t *pMulti;	// kos_WaitMultiple callers, see os_multi.h
+}kosSem_t;
+
+
+/** 
+ * Create a semaphore.
+ * 
+ * Initializes a kosSem_t, usually a static one. Does not enter the
+ * kernel, so do it before any thread uses the semaphore.
+ * A maxCount of 1 makes a binary semaphore.
+ * 
+ * @param pSem is the semaphore
+ * @param count is the initial count
+ * @param maxCount is the highest count kos_SemSignal will reach
+ * @return error code
+ */
+extern
+uint32_t kos_SemCreate(kosSem_t *pSem, uint32_t count, uint32_t maxCount);
+
+
+/** 
+ * Delete a semaphore.
+ * 
+ * Every thread blocked on the semaphore wakes with OS_ERR_DELETED.
+ * 
+ * @param pSem is the semaphore
+ * @return error code
+ */
+extern
+uint32_t kos_SemDelete(kosSem_t *pSem);
+
+
+/** 
+ * Wait on a semaphore.
+ * 
+ * Takes one count. If the count is 0 the calling thread leaves the
+ * ready list until kos_SemSignal hands it a count or the timeout runs
+ * out. Waiters wake highest priority first. Not for ISRs, they must
+ * not block.
+ * 
+ * @param pSem is the semaphore
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return error code, OS_ERR_TIMEOUT if no count was taken
+ */
+extern
+uint32_t kos_SemWait(kosSem_t *pSem, uint32_t timeout);
+
+
+/** 
+ * Take a count if there is one, without blocking.
+ * 
+ * Same as kos_SemWait(pSem, KOS_NO_WAIT).
+ * 
+ * @param pSem is the semaphore
+ * @return error code, OS_ERR_TIMEOUT if the count was 0
+ */
+extern
+uint32_t kos_SemTryWait(kosSem_t *pSem);
+
+
+/** 
+ * Signal a semaphore.
+ * 
+ * Wakes the highest priority waiter, or adds one to the count if no
+ * thread is waiting.
+ * 
+ * @param pSem is the semaphore
+ * @return error code, OS_ERR_SEM_OVF if the count is already maxCount
+ */
+extern
+uint32_t kos_SemSignal(kosSem_t *pSem);
+
+
+/** 
+ * Signal a semaphore from an ISR.
+ * 
+ * Posts the signal to the kernel with kos_PostFromISR. The waiter runs
+ * as soon as the ISRs have returned if it has the highest priority.
+ * 
+ * @param pSem is the semaphore
+ * @return error code, OS_ERR_POST_FULL if the post queue is full
+ */
+extern KOS_RAMFUNC
+uint32_t kos_SemSignalFromISR(kosSem_t *pSem);
+
+
+/** 
+ * Read the count of a semaphore.
+ * 
+ * @param pSem is the semaphore
+ * @return the count, it may change as soon as it is read
+ */
+extern
+uint32_t kos_SemPeek(kosSem_t *pSem);
+
+
+#endif /*OS_SEM_H_*/
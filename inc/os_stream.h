@@ -0,0 +1,106 @@
+/** 
+ * 
+ * \file os_stream.h
+ * Stream buffers, byte pipes with a trigger level
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_STREAM_H_
+#define OS_STREAM_H_
+
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Stream buffer, allocated by the caller and set up with kos_StreamCreate
+typedef struct kosStream_t {
+	uint8_t *pBuffer;
+	uint32_t size;
+	uint32_t count;				// bytes in the buffer
+	uint32_t head;				// offset written next
+	uint32_t tail;				// offset read next
+	uint32_t trigger;			// bytes a blocked reader waits for
+	kosWaitList_t readList;		// threads blocked in kos_StreamRead
+	kosWaitList_t writeList;	// threads blocked in kos_StreamWrite, the buffer is full
+}kosStream_t;
+
+
+/** 
+ * Create a stream buffer.
+ * 
+ * Does not enter the kernel, so do it before any thread uses it.
+ * 
+ * @param pStream is the stream buffer
+ * @param pBuffer is the storage
+ * @param size is the size of pBuffer in bytes
+ * @param trigger is the number of bytes that wakes a blocked reader, 1 to size
+ * @return error code
+ */
+extern
+uint32_t kos_StreamCreate(kosStream_t *pStream, uint8_t *pBuffer, uint32_t size, uint32_t trigger);
+
+
+/** 
+ * Write to a stream buffer.
+ * 
+ * Copies as much as fits and blocks for the rest until readers make
+ * room or the timeout runs out. Wakes a blocked reader once the trigger
+ * level is reached. Not for ISRs.
+ * 
+ * @param pStream is the stream buffer
+ * @param pData is the bytes to write
+ * @param size is the number of bytes
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return the number of bytes written
+ */
+extern
+uint32_t kos_StreamWrite(kosStream_t *pStream, const void *pData, uint32_t size, uint32_t timeout);
+
+
+/** 
+ * Write to a stream buffer from an ISR.
+ * 
+ * Copies as much as fits and never blocks. A blocked reader is woken
+ * through the post queue once the trigger level is reached.
+ * 
+ * @param pStream is the stream buffer
+ * @param pData is the bytes to write
+ * @param size is the number of bytes
+ * @return the number of bytes written
+ */
+extern KOS_RAMFUNC
+uint32_t kos_StreamWriteFromISR(kosStream_t *pStream, const void *pData, uint32_t size);
+
+
+/** 
+ * Read from a stream buffer.
+ * 
+ * Blocks until the trigger level, or size if that is less, is in the
+ * buffer, then reads as much as is there, up to size. After a timeout
+ * it returns whatever is there, which may be nothing. With KOS_NO_WAIT
+ * it never blocks and ignores the trigger level. Not for ISRs.
+ * 
+ * @param pStream is the stream buffer
+ * @param pData is the buffer to read into
+ * @param size is the size of pData in bytes
+ * @param timeout is KOS_NO_WAIT, KOS_WAIT_FOREVER or a number of ticks
+ * @return the number of bytes read
+ */
+extern
+uint32_t kos_StreamRead(kosStream_t *pStream, void *pData, uint32_t size, uint32_t timeout);
+
+
+/** 
+ * Bytes waiting in a stream buffer.
+ * 
+ * @param pStream is the stream buffer
+ * @return the count, it may change as soon as it is read
+ */
+extern
+uint32_t kos_StreamCount(kosStream_t *pStream);
+
+
+#endif /*OS_STREAM_H_*/
@@ -7,16 +7,95 @@
  * 
  * History:
  * 08 JUN 2008 : Created KLW
+ * 18 OCT 2026 : SWI numbers and kernel service table
  * 
  */
 
 #ifndef OS_SWI_H_
 #define OS_SWI_H_
 
+//------------------------------------------------------------------------
+// SWI numbers, the index into kos_swiTable. Shared with os_swi.s.
+// Must stay below 256 so they also fit a Thumb swi instruction.
+#define KOS_SWI_DRIVER              0
+#define KOS_SWI_CREATE_THREAD       1
+#define KOS_SWI_SLEEP               2
+#define KOS_SWI_YIELD               3
+#define KOS_SWI_SWITCH              4
+#define KOS_SWI_SEM_WAIT            5
+#define KOS_SWI_SEM_SIGNAL          6
+#define KOS_SWI_SEM_DELETE          7
+#define KOS_SWI_MUTEX_LOCK          8
+#define KOS_SWI_MUTEX_UNLOCK        9
+#define KOS_SWI_MUTEX_DELETE        10
+#define KOS_SWI_EVENT_WAIT          11
+#define KOS_SWI_EVENT_SET           12
+#define KOS_SWI_EVENT_CLEAR         13
+#define KOS_SWI_EVENT_DELETE        14
+#define KOS_SWI_QUEUE_SEND          15
+#define KOS_SWI_QUEUE_RECEIVE       16
+#define KOS_SWI_QUEUE_DELETE        17
+#define KOS_SWI_BUF_ALLOC           18
+#define KOS_SWI_BUF_ADDREF          19
+#define KOS_SWI_BUF_RELEASE         20
+#define KOS_SWI_NOTIFY              21
+#define KOS_SWI_NOTIFY_WAIT         22
+#define KOS_SWI_STREAM_WRITE        23
+#define KOS_SWI_STREAM_READ         24
+#define KOS_SWI_RW_READ_LOCK        25
+#define KOS_SWI_RW_READ_UNLOCK      26
+#define KOS_SWI_RW_WRITE_LOCK       27
+#define KOS_SWI_RW_WRITE_UNLOCK     28
+#define KOS_SWI_RW_DELETE           29
+#define KOS_SWI_COND_WAIT           30
+#define KOS_SWI_COND_SIGNAL         31
+#define KOS_SWI_COND_BROADCAST      32
+#define KOS_SWI_COND_DELETE         33
+#define KOS_SWI_BARRIER_WAIT        34
+#define KOS_SWI_BARRIER_DELETE      35
+#define KOS_SWI_WAIT_MULTIPLE       36
+#define KOS_SWI_WAIT_MULTIPLE_CANCEL 37
+#define KOS_SWI_WORK_SUBMIT         38
+#define KOS_SWI_WORK_TAKE           39
+#define KOS_SWI_TIMER_START         40
+#define KOS_SWI_TIMER_STOP          41
+#define KOS_SWI_TIMER_NEXT          42
+#define KOS_SWI_ATOMIC_CAS          43
+#define KOS_SWI_ATOMIC_ADD          44
+#define KOS_SWI_ATOMIC_SET_BITS     45
+#define KOS_SWI_ATOMIC_CLEAR_BITS   46
+#define KOS_SWI_POOL_ALLOC          47
+#define KOS_SWI_POOL_FREE           48
+#define KOS_SWI_HEAP_ALLOC          49
+#define KOS_SWI_HEAP_FREE           50
+#define KOS_SWI_HEAP_STATS          51
+
+#define KOS_SWI_COUNT               52
+
+
+#ifndef __ASSEMBLER__
+
+	// Kernel service, arguments arrive in r0-r3 as passed to the SWI stub
+typedef uint32_t (kosSwiFunc_t)(uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4);
+
+	// Kernel service table, indexed by SWI number
+extern
+kosSwiFunc_t * const kos_swiTable[KOS_SWI_COUNT];
+
+	// Driver SWI, arg1 points to the driver call data
 extern
 uint32_t callSWI(uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4);
 
+	// Non-zero if the caller runs in a privileged mode (trusted thread, ISR or kernel)
+extern KOS_RAMFUNC
+uint32_t kos_IsPrivileged(void);
+
+	// Non-zero if the caller runs in IRQ or FIQ mode, unlike kos_IsPrivileged
+	// not for sys mode threads or main
+extern KOS_RAMFUNC
+uint32_t kos_InISR(void);
 
+#endif /*__ASSEMBLER__*/
 
 
 #endif /*OS_SWI_H_*/
@@ -0,0 +1,103 @@
+/** 
+ * 
+ * \file os_timer.h
+ * Software timers
+ *
+ * Timers call a function after a number of ticks, once or periodically.
+ * The functions run in the timer thread, started with
+ * kos_TimerServiceStart, one after another, so keep them short and
+ * never block in them.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_TIMER_H_
+#define OS_TIMER_H_
+
+
+// Slots in the timer wheel, a power of two. More slots mean fewer
+// timers to skip per tick when many are running.
+#ifndef KOS_TIMER_WHEEL_SIZE
+#define KOS_TIMER_WHEEL_SIZE    32
+#endif
+
+// Static initializer for a timer
+#define KOS_TIMER_INIT(func, arg)   { 0, 0, (func), (arg), 0, 0, 0 }
+
+//--------------------------------------------------------------
+// typedefs
+
+typedef void (kosTimerFunc_t)(void *pArg);
+
+	// Software timer, allocated by the caller
+typedef struct kosTimer_t {
+	struct kosTimer_t *pNext;		// wheel slot
+	struct kosTimer_t *pPrev;
+	kosTimerFunc_t *pFunc;
+	void *pArg;
+	uint32_t expire;				// tick it fires
+	uint32_t period;				// 0 for a one-shot timer
+	uint32_t active;				// non-zero while on the wheel
+	uint32_t slot;					// wheel slot it is in, while active
+}kosTimer_t;
+
+
+/** 
+ * Start the timer thread.
+ * 
+ * Call once, from main or a thread. The thread only runs when a timer
+ * has fired.
+ * 
+ * @param pri is the priority of the timer thread
+ * @param stack is its stack
+ * @param stackSize is the size of the stack in words
+ * @return error code
+ */
+extern
+uint32_t kos_TimerServiceStart(uint8_t pri, KOS_STK *stack, uint32_t stackSize);
+
+
+/** 
+ * Set up a timer.
+ * 
+ * The same as KOS_TIMER_INIT. Not while the timer is running.
+ * 
+ * @param pTimer is the timer
+ * @param pFunc is called when the timer fires
+ * @param pArg is passed to pFunc
+ * @return error code
+ */
+extern
+uint32_t kos_TimerInit(kosTimer_t *pTimer, kosTimerFunc_t *pFunc, void *pArg);
+
+
+/** 
+ * Start a timer.
+ * 
+ * Restarts it if it is already running. Not for ISRs.
+ * 
+ * @param pTimer is the timer
+ * @param ticks is the number of ticks to the first call, at least 1
+ * @param period is the number of ticks between calls, 0 for just one
+ * @return error code
+ */
+extern
+uint32_t kos_TimerStart(kosTimer_t *pTimer, uint32_t ticks, uint32_t period);
+
+
+/** 
+ * Stop a timer.
+ * 
+ * A call the timer thread has already taken still happens. Not for
+ * ISRs.
+ * 
+ * @param pTimer is the timer
+ * @return error code
+ */
+extern
+uint32_t kos_TimerStop(kosTimer_t *pTimer);
+
+
+#endif /*OS_TIMER_H_*/
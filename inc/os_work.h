@@ -0,0 +1,121 @@
+/** 
+ * 
+ * \file os_work.h
+ * Work queues
+ *
+ * A work item is a function and its argument, run later by one of the
+ * worker threads of a work queue. Items belong to the caller, usually
+ * static, so submitting never allocates and the queue cannot fill up.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#ifndef OS_WORK_H_
+#define OS_WORK_H_
+
+
+// Static initializer for a work item
+#define KOS_WORK_INIT(func, arg)    { 0, (func), (arg), 0 }
+
+//--------------------------------------------------------------
+// typedefs
+
+typedef void (kosWorkFunc_t)(void *pArg);
+
+	// Work item, allocated by the caller
+typedef struct kosWork_t {
+	struct kosWork_t *pNext;		// next item on the queue
+	kosWorkFunc_t *pFunc;
+	void *pArg;
+	uint32_t pending;				// non-zero while on the queue
+}kosWork_t;
+
+	// Work queue, allocated by the caller and set up with kos_WorkQueueCreate
+typedef struct kosWorkQueue_t {
+	kosWork_t *pHead;
+	kosWork_t *pTail;
+	kosWaitList_t waitList;			// idle workers
+}kosWorkQueue_t;
+
+
+/** 
+ * Create a work queue.
+ * 
+ * Does not enter the kernel, so do it before any thread uses the
+ * queue. Give it workers with kos_WorkQueueStart.
+ * 
+ * @param pQueue is the work queue
+ * @return error code
+ */
+extern
+uint32_t kos_WorkQueueCreate(kosWorkQueue_t *pQueue);
+
+
+/** 
+ * Add a worker thread to a work queue.
+ * 
+ * Call once for each worker. Items run in the order submitted, each on
+ * whichever worker is free, so with more than one worker they may
+ * overlap.
+ * 
+ * @param pQueue is the work queue
+ * @param pri is the priority of the worker
+ * @param pszName is the name of the worker
+ * @param stack is the worker's stack
+ * @param stackSize is the size of the stack in words
+ * @return error code
+ */
+extern
+uint32_t kos_WorkQueueStart(kosWorkQueue_t *pQueue, uint8_t pri, const char *pszName, KOS_STK *stack, uint32_t stackSize);
+
+
+/** 
+ * Set up a work item.
+ * 
+ * The same as KOS_WORK_INIT. Not while the item is pending.
+ * 
+ * @param pWork is the work item
+ * @param pFunc is the function to run
+ * @param pArg is passed to pFunc
+ * @return error code
+ */
+extern
+uint32_t kos_WorkInit(kosWork_t *pWork, kosWorkFunc_t *pFunc, void *pArg);
+
+
+/** 
+ * Submit a work item.
+ * 
+ * Never blocks. An item already waiting on a queue stays where it is,
+ * so it runs once however many times it was submitted. An item that is
+ * running may be submitted again, also from its own function. Not for
+ * ISRs, use kos_WorkSubmitFromISR.
+ * 
+ * @param pQueue is the work queue
+ * @param pWork is the work item
+ * @return error code
+ */
+extern
+uint32_t kos_WorkSubmit(kosWorkQueue_t *pQueue, kosWork_t *pWork);
+
+
+/** 
+ * Submit a work item from an ISR.
+ * 
+ * As kos_WorkSubmit. An idle worker is woken through the post queue as
+ * soon as the ISRs have returned. OS_ERR_POST_FULL means the item is
+ * queued but the wake is deferred, it need not be submitted again. The
+ * next submit to the queue, or a worker coming back for more, hands it
+ * over.
+ * 
+ * @param pQueue is the work queue
+ * @param pWork is the work item
+ * @return error code, OS_ERR_POST_FULL if the wake was deferred
+ */
+extern KOS_RAMFUNC
+uint32_t kos_WorkSubmitFromISR(kosWorkQueue_t *pQueue, kosWork_t *pWork);
+
+
+#endif /*OS_WORK_H_*/
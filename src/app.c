@@ -11,6 +11,8 @@
 #include <stdint.h>
 #include "error_codes.h"
 #include "os_core.h"
+#include "os_sem.h"
+#include "os_event.h"
 
 #include "os_driver.h"
 
@@ -45,7 +47,6 @@ DriverHandle_t gDrvHandle = 0;
 void thread1Entry(void *pData)
 {
 	GlobalDataStr_t *s = (GlobalDataStr_t *)pData;
-	volatile uint32_t cnt = 0;
 	uint32_t retVal = 0;
 	uint32_t byteCount = 16;
 	uint8_t pBytes[16] = {5,6,7,8,9,12,0,0,0,250,0,0,0,0,0,0};
@@ -61,16 +62,16 @@ void thread1Entry(void *pData)
 		
 		s->t1++;
 		
-		if (s->guard==0)
+		if (OS_NO_ERR == kos_SemWait(&s->lock, KOS_WAIT_FOREVER))
 		{
 			uint32_t tmp = byteCount;
-			s->guard = 1;
 			kos_DriverWrite(gDrvHandle, 0, pBytes, &tmp);
 			s->inc++;
-			s->guard = 0;
+			kos_SemSignal(&s->lock);
+			kos_EventSet(&s->events, APP_EVENT_T1);
 		}
-		cnt = 0x8FFF;
-		while ( cnt-- ) {}
+		
+		kos_Sleep(8);
 	}
 	
 }
@@ -87,7 +88,6 @@ void thread1Entry(void *pData)
 void thread2Entry(void *pData)
 {
 	GlobalDataStr_t *s = (GlobalDataStr_t *)pData;
-	volatile uint32_t cnt = 0;
 	
 	while (1)
 	{
@@ -95,15 +95,14 @@ void thread2Entry(void *pData)
 		
 		s->t2++;
 		
-		if (s->guard==0)
+		if (OS_NO_ERR == kos_SemWait(&s->lock, KOS_WAIT_FOREVER))
 		{
-			s->guard = 1;
 			s->inc--;
-			s->guard = 0;
+			kos_SemSignal(&s->lock);
+			kos_EventSet(&s->events, APP_EVENT_T2);
 		}
 		
-		cnt = 0xFFF;
-		while ( cnt-- ) {}
+		kos_Sleep(1);
 	}
 	
 }
@@ -111,8 +110,8 @@ void thread2Entry(void *pData)
 /** 
  * Thread 3.
  * 
- * Casts pData to GlobalDataStr_t and checks the inc variable.
- * Returns error if inc is larger then 3.
+ * Casts pData to GlobalDataStr_t and checks the inc variable once both
+ * other threads have changed it. Resets inc if it is larger then 0x7F.
  * 
  * @param pData is a pointer to shared data
  * 
@@ -120,23 +119,22 @@ void thread2Entry(void *pData)
 void thread3Entry(void *pData)
 {
 	GlobalDataStr_t *s = (GlobalDataStr_t *)pData;
-	volatile uint32_t cnt = 0;
 	
 	while (1)
 	{
 		printf("3t\n\r");
 		
-		if (s->guard==0)
+		// blocks until threads 1 and 2 have both been round, or a second has passed
+		kos_EventWait(&s->events, APP_EVENT_T1|APP_EVENT_T2, KOS_EVENT_ALL|KOS_EVENT_CLEAR, 100, 0);
+		
+		// skip the check rather than hold up the loop
+		if (OS_NO_ERR == kos_SemWait(&s->lock, 2))
 		{
-			s->guard = 1;
 			if ( s->inc > 0x7F ) {
 				s->inc = 0;
 			}
-			s->guard = 0;
+			kos_SemSignal(&s->lock);
 		}
-		
-		cnt = 0xFFF;
-		while ( cnt-- ) {}
 	}
 	
 }
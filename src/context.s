@@ -2,19 +2,28 @@
 
 .global TimerTickISR
 .global Restore_Context
+.global kos_SwitchFromSWI
+.global kos_PendISR
 .global TestISR
 
-.text
+/* ARM code, typed so Thumb callers get interworking calls */
+.type TimerTickISR, %function
+.type Restore_Context, %function
+.type kos_SwitchFromSWI, %function
+.type kos_PendISR, %function
+.type TestISR, %function
+
+/* the whole switch path runs from RAM, see KOS_RAMFUNC */
+.section .ramfunc, "ax"
 .code 32
 .align 0
      
 
-TimerTickISR:
-	/* -- Save_Context -- */ 
+/* -- Save_Context -- */ 
 /* Adapted from FreeRTOS V5.0.0 port to lpc23xx for GCC*/
 /* cannot be in sys or usr modes */
-	/* Correct for LR offset in irq mode */ 
-	SUB	LR, LR, #4
+/* LR must hold the address the task resumes at */
+.macro SAVE_CONTEXT
 	/*store r0 so it can be used to get the usr/sys stack pointer */
 	STMDB	SP!, {R0}
 
@@ -56,8 +65,15 @@ TimerTickISR:
 	LDR	R0, =kos_threadCurr
 	LDR	R0, [R0]
 	STR	LR, [R0]
-	
+.endm
 	/* -- End Save Context -- */
+
+
+TimerTickISR:
+	/* Correct for LR offset in irq mode */ 
+	SUB	LR, LR, #4
+	
+	SAVE_CONTEXT
 	
 	LDR		r2, =kos_TimerTick
 	MOV		lr, pc
@@ -69,6 +85,43 @@ TimerTickISR:
 	
 	
 	/* return and continue with Restore_Context */
+	B		Restore_Context
+	
+
+/* Kernel pend, VIC software interrupt raised by kos_PostFromISR */
+/* Runs after the posting ISR and switches if a request woke a higher priority thread */
+kos_PendISR:
+	/* Correct for LR offset in irq mode */ 
+	SUB	LR, LR, #4
+	
+	SAVE_CONTEXT
+	
+	LDR		r2, =kos_PendService
+	MOV		lr, pc
+	BX		r2			/* clear the interrupt, run requests posted by ISRs */
+	
+	LDR		r2, =kos_ScheduleNext
+	MOV		lr, pc
+	BX		r2			/* jump to kos_ScheduleNext */
+	
+	/* return and continue with Restore_Context */
+	B		Restore_Context
+	
+
+/* Pended switch at the end of a SWI, entered from handleSWI in svc mode */
+/* LR is the resume address of the calling task, R0 its SWI return value */
+kos_SwitchFromSWI:
+	SAVE_CONTEXT
+	
+	LDR		r2, =kos_PostDrain
+	MOV		lr, pc
+	BX		r2			/* run requests posted by ISRs */
+	
+	LDR		r2, =kos_ScheduleNext
+	MOV		lr, pc
+	BX		r2			/* jump to kos_ScheduleNext */
+	
+	/* continue with Restore_Context */
 	
 
 /* Save_Context - Adapted from FreeRTOS V5.0.0 port to lpc23xx for GCC*/
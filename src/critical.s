@@ -1,11 +1,21 @@
 .global InterruptsDisable
 .global InterruptsEnable
 .global InterruptsRestore
+.global kos_IsPrivileged
+.global kos_InISR
+
+/* ARM code, typed so Thumb callers get interworking calls */
+.type InterruptsDisable, %function
+.type InterruptsEnable, %function
+.type InterruptsRestore, %function
+.type kos_IsPrivileged, %function
+.type kos_InISR, %function
 
 .set ARM_SR_DISABLE_FIQ_AND_IRQ,         0xC0   /* Disable both FIQ & IRQ */
 .set ARM_SR_BIT_IRQ,                     0x80   /* IRQ bit */
 
-.text
+/* called from the switch path and from RAM ISRs, see KOS_RAMFUNC */
+.section .ramfunc, "ax"
 .arm
 
 /* uint32_t InterruptsDisable(void); */
@@ -26,5 +36,21 @@ InterruptsEnable:
 InterruptsRestore:
 	MSR CPSR_c, r0                 				/* load CPSR */
 	bx lr
+
+/* uint32_t kos_IsPrivileged(void); */
+kos_IsPrivileged:
+	MRS r0, CPSR                    			/* get CPSR */
+	ANDS r0, r0, #0x0F                 			/* user mode is 0x10, all others non-zero */
+	bx lr
+
+/* uint32_t kos_InISR(void); */
+kos_InISR:
+	MRS r0, CPSR                    			/* get CPSR */
+	AND r0, r0, #0x1F                 			/* mode bits */
+	SUB r0, r0, #0x11                 			/* FIQ 0x11 -> 0, IRQ 0x12 -> 1 */
+	CMP r0, #1
+	MOVLS r0, #1
+	MOVHI r0, #0
+	bx lr
 	
 .end
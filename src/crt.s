@@ -112,6 +112,18 @@ copyloop:
      STRLO   r0, [r2], #4
      BLO     copyloop
 
+/* 
+ * Copy .ramfunc section (copy KOS_RAMFUNC code from ROM to RAM)
+ */
+     LDR     r1, =__ramfunc_load
+     LDR     r2, =__ramfunc_start
+     LDR     r3, =__ramfunc_end
+ramfuncloop:   
+     CMP     r2, r3
+     LDRLO   r0, [r1], #4
+     STRLO   r0, [r2], #4
+     BLO     ramfuncloop
+
 /*
  * zero .bss section
  */
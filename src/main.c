@@ -22,6 +22,9 @@
 //#include "print.h"
 
 #include "os_core.h"
+#include "os_sem.h"
+#include "os_event.h"
+#include "os_heap.h"
 #include "os_driver.h"
 
 #include "drv_test.h"
@@ -32,10 +35,6 @@
 
 
 
-extern uint32_t InterruptsDisable(void);
-extern void InterruptsEnable(uint32_t cpsr);
-
-
 extern void _startup(void); // for debugging startup code
 
 
@@ -155,6 +154,10 @@ int main( void )
      */
     
     kos_InitOS();
+    kos_HeapInit();
+    
+    kos_SemCreate(&shared.lock, 1, 1);
+    kos_EventCreate(&shared.events, 0);
     
     kos_CreateThread(  25, "Thread 1", thread1Stack, STACK_SIZE, thread1Entry, (void*)&shared);
     kos_CreateThread(  25, "Thread 2", thread2Stack, STACK_SIZE, thread2Entry, (void*)&shared);
@@ -0,0 +1,249 @@
+/** 
+ * 
+ * \file os_ao.c
+ * Active objects
+ *
+ * Built on threads and mailboxes, with no kernel state of its own. The
+ * timer is kept by the object's thread: it waits for events no longer
+ * than the timer has left to run, so a timer costs nothing but a
+ * timeout on a wait the thread makes anyway. The timer fields are only
+ * touched by the object's own thread.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_queue.h"
+#include "os_mbox.h"
+#include "os_ao.h"
+
+//--------------------------------------------------------------
+// local function prototypes
+static void kos_AoThread(void *pData);
+static void kos_AoTimerFire(kosAo_t *pAo);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Dispatch the timer event and set up the next one.
+ */
+static void kos_AoTimerFire(kosAo_t *pAo)
+{
+	if (pAo->timePeriod)
+	{
+		pAo->timeDue += pAo->timePeriod;
+	}
+	else
+	{
+		pAo->timeArmed = FALSE;
+	}
+	
+	pAo->timeEvt.tag = pAo->timeSig;
+	pAo->pDispatch(pAo, &pAo->timeEvt);
+}
+
+/*
+ * Thread of an active object.
+ */
+static void kos_AoThread(void *pData)
+{
+	kosAo_t *pAo = (kosAo_t *)pData;
+	kosBuf_t *pEvt;
+	uint32_t timeout;
+	int32_t left;
+	
+	pAo->timeEvt.tag = KOS_AO_SIG_INIT;
+	pAo->pDispatch(pAo, &pAo->timeEvt);
+	
+	while (1)
+	{
+		timeout = KOS_WAIT_FOREVER;
+		
+		if (pAo->timeArmed)
+		{
+			left = (int32_t)(pAo->timeDue - kos_TickCount());
+			if (left <= 0)
+			{
+				kos_AoTimerFire(pAo);
+				continue;
+			}
+			timeout = (uint32_t)left;
+		}
+		
+		if (OS_NO_ERR == kos_MboxReceive(&pAo->queue, &pEvt, timeout))
+		{
+			pAo->pDispatch(pAo, pEvt);
+			
+			// the queue's reference, kos_AoDefer took its own
+			kos_BufRelease(pEvt);
+		}
+	}
+}
+
+/**** Public Functions ****/
+
+/*
+ * Create an active object. Documented in os_ao.h
+ */
+uint32_t kos_AoCreate(kosAo_t *pAo, kosAoDispatch_t *pDispatch, void *pData,
+		uint32_t *pQueue, uint32_t queueLen, uint32_t *pDefer, uint32_t deferLen)
+{
+	uint32_t err;
+	
+	if ((0 == pAo) || (0 == pDispatch))
+	{
+		return ERR_ARG;
+	}
+	
+	err = kos_MboxCreate(&pAo->queue, pQueue, queueLen);
+	if (CHECK_ERROR(err))
+	{
+		return err;
+	}
+	
+	// an object that never defers has an empty deferred queue that is never created
+	pAo->deferred.queue.itemCount = 0;
+	if (pDefer)
+	{
+		err = kos_MboxCreate(&pAo->deferred, pDefer, deferLen);
+		if (CHECK_ERROR(err))
+		{
+			return err;
+		}
+	}
+	
+	pAo->pDispatch = pDispatch;
+	pAo->pData = pData;
+	pAo->timeEvt.pNext = 0;
+	pAo->timeEvt.pPool = 0;
+	pAo->timeEvt.refCount = 0;
+	pAo->timeEvt.length = 0;
+	pAo->timeEvt.tag = KOS_AO_SIG_INIT;
+	pAo->timeArmed = FALSE;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Start an active object's thread. Documented in os_ao.h
+ */
+uint32_t kos_AoStart(kosAo_t *pAo, uint8_t pri, const char *pszName, KOS_STK *stack, uint32_t stackSize)
+{
+	if (0 == pAo)
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_CreateThread(pri, pszName, stack, stackSize, kos_AoThread, pAo);
+}
+
+/*
+ * Post an event to an active object. Documented in os_ao.h
+ */
+uint32_t kos_AoPost(kosAo_t *pAo, kosBuf_t *pEvt)
+{
+	if (0 == pAo)
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_MboxPost(&pAo->queue, pEvt, KOS_NO_WAIT);
+}
+
+/*
+ * Post an event to an active object from an ISR. Documented in os_ao.h
+ */
+KOS_RAMFUNC uint32_t kos_AoPostFromISR(kosAo_t *pAo, kosBuf_t *pEvt)
+{
+	if (0 == pAo)
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_MboxPostFromISR(&pAo->queue, pEvt);
+}
+
+/*
+ * Put the event being dispatched aside. Documented in os_ao.h
+ */
+uint32_t kos_AoDefer(kosAo_t *pAo, kosBuf_t *pEvt)
+{
+	if ((0 == pAo) || (0 == pAo->deferred.queue.itemCount) || (&pAo->timeEvt == pEvt))
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_MboxPost(&pAo->deferred, pEvt, KOS_NO_WAIT);
+}
+
+/*
+ * Post the oldest deferred event back. Documented in os_ao.h
+ */
+uint32_t kos_AoRecall(kosAo_t *pAo)
+{
+	kosBuf_t *pEvt;
+	uint32_t err;
+	
+	if ((0 == pAo) || (0 == pAo->deferred.queue.itemCount))
+	{
+		return ERR_ARG;
+	}
+	
+	err = kos_MboxReceive(&pAo->deferred, &pEvt, KOS_NO_WAIT);
+	if (CHECK_ERROR(err))
+	{
+		return err;
+	}
+	
+	// a full queue leaves it deferred, only this thread defers so there is room
+	err = kos_MboxPost(&pAo->queue, pEvt, KOS_NO_WAIT);
+	if (CHECK_ERROR(err))
+	{
+		kos_MboxPost(&pAo->deferred, pEvt, KOS_NO_WAIT);
+	}
+	kos_BufRelease(pEvt);
+	
+	return err;
+}
+
+/*
+ * Arm the object's timer. Documented in os_ao.h
+ */
+uint32_t kos_AoTimerArm(kosAo_t *pAo, uint32_t sig, uint32_t ticks, uint32_t period)
+{
+	if ((0 == pAo) || (0 == ticks))
+	{
+		return ERR_ARG;
+	}
+	
+	pAo->timeSig = sig;
+	pAo->timeDue = kos_TickCount() + ticks;
+	pAo->timePeriod = period;
+	pAo->timeArmed = TRUE;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Disarm the object's timer. Documented in os_ao.h
+ */
+uint32_t kos_AoTimerDisarm(kosAo_t *pAo)
+{
+	if (0 == pAo)
+	{
+		return ERR_ARG;
+	}
+	
+	pAo->timeArmed = FALSE;
+	
+	return OS_NO_ERR;
+}
+
+/**** End Public Functions ****/
@@ -0,0 +1,110 @@
+/** 
+
+\file os_atomic.s
+ * Atomic operations on 32 bit words
+ *
+ * Each operation is a read-modify-write of r0's word into r3, with the
+ * old value returned in r0. Privileged callers run it between two MSRs
+ * masking IRQ and FIQ. USER mode callers cannot mask, so they trap to
+ * the same code as a kernel service: the SWI vector already has IRQ
+ * masked and the service never pends a switch, so the trap returns
+ * straight to the caller.
+ * 
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include "os_swi.h"
+
+.set I_BIT,                 0x80
+.set F_BIT,                 0x40
+
+.global kos_AtomicSwap
+.global kos_svcAtomicCas
+.global kos_svcAtomicAdd
+.global kos_svcAtomicSetBits
+.global kos_svcAtomicClearBits
+
+/* ARM code, typed so Thumb callers get interworking calls */
+.type kos_AtomicSwap, %function
+.type kos_svcAtomicCas, %function
+.type kos_svcAtomicAdd, %function
+.type kos_svcAtomicSetBits, %function
+.type kos_svcAtomicClearBits, %function
+
+/* called from RAM ISRs, see KOS_RAMFUNC */
+.section .ramfunc, "ax"
+.arm
+.align 2
+
+
+/* r3 = old value of [r0], the new value is stored, r0-r2 are the arguments */
+.macro OP_CAS
+	LDR		R3, [R0]
+	CMP		R3, R1
+	STREQ	R2, [R0]
+.endm
+
+.macro OP_ADD
+	LDR		R3, [R0]
+	ADD		R2, R3, R1
+	STR		R2, [R0]
+.endm
+
+.macro OP_SET_BITS
+	LDR		R3, [R0]
+	ORR		R2, R3, R1
+	STR		R2, [R0]
+.endm
+
+.macro OP_CLEAR_BITS
+	LDR		R3, [R0]
+	BIC		R2, R3, R1
+	STR		R2, [R0]
+.endm
+
+/*
+ * Public entry for an operation, and its kernel service for the trap.
+ */
+.macro ATOMIC name, num, svc, op
+	.global \name
+	.type \name, %function
+\name:
+	MRS		R12, CPSR
+	TST		R12, #0x0F					/* user mode is 0x10 */
+	SWIEQ	\num						/* r0 = svc(r0, r1, r2) */
+	BXEQ	LR
+	ORR		R3, R12, #I_BIT|F_BIT
+	MSR		CPSR_c, R3
+	\op
+	MSR		CPSR_c, R12
+	MOV		R0, R3
+	BX		LR
+
+\svc:
+	\op
+	MOV		R0, R3
+	BX		LR
+.endm
+
+
+/* uint32_t kos_AtomicSwap(volatile uint32_t *p, uint32_t value) */
+kos_AtomicSwap:
+	SWP		R2, R1, [R0]
+	MOV		R0, R2
+	BX		LR
+
+/* uint32_t kos_AtomicCas(volatile uint32_t *p, uint32_t expected, uint32_t desired) */
+	ATOMIC kos_AtomicCas, KOS_SWI_ATOMIC_CAS, kos_svcAtomicCas, OP_CAS
+
+/* uint32_t kos_AtomicAdd(volatile uint32_t *p, uint32_t value) */
+	ATOMIC kos_AtomicAdd, KOS_SWI_ATOMIC_ADD, kos_svcAtomicAdd, OP_ADD
+
+/* uint32_t kos_AtomicSetBits(volatile uint32_t *p, uint32_t bits) */
+	ATOMIC kos_AtomicSetBits, KOS_SWI_ATOMIC_SET_BITS, kos_svcAtomicSetBits, OP_SET_BITS
+
+/* uint32_t kos_AtomicClearBits(volatile uint32_t *p, uint32_t bits) */
+	ATOMIC kos_AtomicClearBits, KOS_SWI_ATOMIC_CLEAR_BITS, kos_svcAtomicClearBits, OP_CLEAR_BITS
+
+.end
@@ -0,0 +1,133 @@
+/** 
+ * 
+ * \file os_barrier.c
+ * Barriers
+ *
+ * There is no arrival count. Arrivals that time out are taken off the
+ * wait list by the tick, which knows nothing of barriers, so the
+ * waiters are counted from the list at each arrival instead. Barriers
+ * are for a handful of threads, so the walk is short.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_barrier.h"
+
+//--------------------------------------------------------------
+// external functions
+
+extern uint32_t kos_swiBarrierWait(kosBarrier_t *pBarrier, uint32_t timeout);
+
+//--------------------------------------------------------------
+// functions
+
+/**** Kernel Functions ****/
+
+/*
+ * Wait at a barrier. Kernel side of kos_BarrierWait.
+ */
+uint32_t kos_svcBarrierWait(kosBarrier_t *pBarrier, uint32_t timeout)
+{
+	threadTCB_t *pThread;
+	uint32_t arrived = 1;
+	uint32_t now = kos_TickCount();
+	
+	if (0 == pBarrier)
+	{
+		return ERR_ARG;
+	}
+	
+	for (pThread = pBarrier->waitList.pHead; pThread; pThread = pThread->pWaitNext)
+	{
+		arrived++;
+	}
+	
+	if (arrived < pBarrier->parties)
+	{
+		if (1 == arrived)
+		{
+			pBarrier->phaseStart = now;
+		}
+		return kos_WaitBlock(&pBarrier->waitList, timeout);
+	}
+	
+	// last one in opens it for this phase
+	pBarrier->lastWait = now - pBarrier->phaseStart;
+	if (pBarrier->lastWait > pBarrier->maxWait)
+	{
+		pBarrier->maxWait = pBarrier->lastWait;
+	}
+	pBarrier->phase++;
+	
+	kos_WaitWakeAll(&pBarrier->waitList, OS_NO_ERR);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Delete a barrier. Kernel side of kos_BarrierDelete.
+ */
+uint32_t kos_svcBarrierDelete(kosBarrier_t *pBarrier)
+{
+	if (0 == pBarrier)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_WaitWakeAll(&pBarrier->waitList, OS_ERR_DELETED);
+	
+	return OS_NO_ERR;
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a barrier. Documented in os_barrier.h
+ */
+uint32_t kos_BarrierCreate(kosBarrier_t *pBarrier, uint32_t parties)
+{
+	if ((0 == pBarrier) || (0 == parties))
+	{
+		return ERR_ARG;
+	}
+	
+	pBarrier->parties = parties;
+	pBarrier->phase = 0;
+	pBarrier->phaseStart = 0;
+	pBarrier->lastWait = 0;
+	pBarrier->maxWait = 0;
+	kos_WaitListInit(&pBarrier->waitList);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Wait at a barrier. Documented in os_barrier.h
+ */
+uint32_t kos_BarrierWait(kosBarrier_t *pBarrier, uint32_t timeout, uint32_t *pWaited)
+{
+	uint32_t start = kos_TickCount();
+	uint32_t err;
+	
+	err = kos_swiBarrierWait(pBarrier, timeout);
+	
+	if (pWaited)
+	{
+		*pWaited = kos_TickCount() - start;
+	}
+	
+	return err;
+}
+
+/**** End Public Functions ****/
@@ -0,0 +1,95 @@
+/** 
+ * 
+ * \file os_bus.c
+ * Publish/subscribe event bus
+ *
+ * Built on mailboxes, so the bus itself has no kernel state. A topic
+ * is published by walking its table entry, posting with KOS_NO_WAIT
+ * so that one slow subscriber cannot stall the publisher.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_queue.h"
+#include "os_mbox.h"
+#include "os_bus.h"
+
+//--------------------------------------------------------------
+// functions
+
+/**** Public Functions ****/
+
+/*
+ * Publish an event. Documented in os_bus.h
+ */
+uint32_t kos_BusPublish(kosBus_t *pBus, uint32_t topic, kosBuf_t *pBuf)
+{
+	const kosTopic_t *pTopic;
+	uint32_t result = OS_NO_ERR;
+	uint32_t err;
+	uint32_t i;
+	
+	if ((0 == pBus) || (topic >= pBus->topicCount) || (0 == pBuf))
+	{
+		return ERR_ARG;
+	}
+	
+	pTopic = &pBus->pTopics[topic];
+	pBuf->tag = topic;
+	
+	for (i = 0; i < pTopic->subCount; i++)
+	{
+		err = kos_MboxPost(pTopic->ppSubs[i], pBuf, KOS_NO_WAIT);
+		if (CHECK_ERROR(err))
+		{
+			result = OS_ERR_QUEUE_FULL;
+		}
+	}
+	
+	// the publisher's reference, the subscribers now hold their own
+	kos_BufRelease(pBuf);
+	
+	return result;
+}
+
+/*
+ * Publish an event from an ISR. Documented in os_bus.h
+ */
+KOS_RAMFUNC uint32_t kos_BusPublishFromISR(kosBus_t *pBus, uint32_t topic, kosBuf_t *pBuf)
+{
+	const kosTopic_t *pTopic;
+	uint32_t result = OS_NO_ERR;
+	uint32_t err;
+	uint32_t i;
+	
+	if ((0 == pBus) || (topic >= pBus->topicCount) || (0 == pBuf))
+	{
+		return ERR_ARG;
+	}
+	
+	pTopic = &pBus->pTopics[topic];
+	pBuf->tag = topic;
+	
+	for (i = 0; i < pTopic->subCount; i++)
+	{
+		// OS_ERR_POST_FULL still queued the buffer
+		err = kos_MboxPostFromISR(pTopic->ppSubs[i], pBuf);
+		if (OS_ERR_QUEUE_FULL == err)
+		{
+			result = OS_ERR_QUEUE_FULL;
+		}
+	}
+	
+	kos_BufReleaseFromISR(pBuf);
+	
+	return result;
+}
+
+/**** End Public Functions ****/
@@ -0,0 +1,199 @@
+/** 
+ * 
+ * \file os_cond.c
+ * Condition variables
+ *
+ * A signalled waiter is not made ready. It is moved from the condition
+ * variable's wait list onto its mutex's, or handed the mutex if it is
+ * free, so only the thread that can run next is woken. pWaitData holds
+ * the waiter's mutex while it is on the condition variable. A broadcast
+ * merges the waiters into the mutex's list in one pass.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_mutex.h"
+#include "os_cond.h"
+
+//--------------------------------------------------------------
+// external functions
+
+extern uint32_t kos_swiCondWait(kosCond_t *pCond, kosMutex_t *pMutex, uint32_t timeout);
+
+//--------------------------------------------------------------
+// local function prototypes
+static void kos_CondMove(threadTCB_t *pThread);
+
+//--------------------------------------------------------------
+// functions
+
+/**** Kernel Functions ****/
+
+/*
+ * Move a signalled waiter onto its mutex, or hand it the mutex if it is free.
+ */
+static void kos_CondMove(threadTCB_t *pThread)
+{
+	kosMutex_t *pMutex = (kosMutex_t *)pThread->pWaitData;
+	
+	if (0 == pMutex->waitList.pOwner)
+	{
+		kos_ThreadWake(pThread, OS_NO_ERR);
+		kos_OwnerSet(&pMutex->waitList, pThread);
+		pMutex->nesting = 1;
+		return;
+	}
+	
+	// kos_svcMutexUnlock wakes it with OS_NO_ERR once it is its turn
+	kos_WaitRequeue(pThread, &pMutex->waitList);
+}
+
+/*
+ * Wait on a condition variable. Kernel side of kos_CondWait.
+ */
+uint32_t kos_svcCondWait(kosCond_t *pCond, kosMutex_t *pMutex, uint32_t timeout)
+{
+	if ((0 == pCond) || (0 == pMutex))
+	{
+		return ERR_ARG;
+	}
+	
+	if ((0 == kos_threadCurr) || (kos_threadCurr != pMutex->waitList.pOwner))
+	{
+		return OS_ERR_NOT_OWNER;
+	}
+	
+	// kos_CondWait locks it again as many times as it was, after the wait
+	pMutex->nesting = 1;
+	kos_svcMutexUnlock(pMutex);
+	
+	kos_threadCurr->pWaitData = pMutex;
+	
+	return kos_WaitBlock(&pCond->waitList, timeout);
+}
+
+/*
+ * Signal a condition variable. Kernel side of kos_CondSignal.
+ */
+uint32_t kos_svcCondSignal(kosCond_t *pCond)
+{
+	if (0 == pCond)
+	{
+		return ERR_ARG;
+	}
+	
+	if (pCond->waitList.pHead)
+	{
+		kos_CondMove(pCond->waitList.pHead);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Signal every waiter. Kernel side of kos_CondBroadcast.
+ */
+uint32_t kos_svcCondBroadcast(kosCond_t *pCond)
+{
+	kosMutex_t *pMutex;
+	
+	if (0 == pCond)
+	{
+		return ERR_ARG;
+	}
+	
+	// one splice per mutex, waiters normally all share the same one
+	while (pCond->waitList.pHead)
+	{
+		pMutex = (kosMutex_t *)pCond->waitList.pHead->pWaitData;
+		if (0 == pMutex->waitList.pOwner)
+		{
+			kos_CondMove(pCond->waitList.pHead);
+		}
+		kos_WaitSplice(&pCond->waitList, &pMutex->waitList, pMutex);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Delete a condition variable. Kernel side of kos_CondDelete.
+ */
+uint32_t kos_svcCondDelete(kosCond_t *pCond)
+{
+	if (0 == pCond)
+	{
+		return ERR_ARG;
+	}
+	
+	// kos_CondWait locks the mutex again itself, as after a timeout
+	kos_WaitWakeAll(&pCond->waitList, OS_ERR_DELETED);
+	
+	return OS_NO_ERR;
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a condition variable. Documented in os_cond.h
+ */
+uint32_t kos_CondCreate(kosCond_t *pCond)
+{
+	if (0 == pCond)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_WaitListInit(&pCond->waitList);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Wait on a condition variable. Documented in os_cond.h
+ */
+uint32_t kos_CondWait(kosCond_t *pCond, kosMutex_t *pMutex, uint32_t timeout)
+{
+	uint32_t nesting;
+	uint32_t err;
+	
+	if ((0 == pCond) || (0 == pMutex))
+	{
+		return ERR_ARG;
+	}
+	
+	// only the owner changes nesting while it owns the mutex
+	if (kos_ThreadSelf() != pMutex->waitList.pOwner)
+	{
+		return OS_ERR_NOT_OWNER;
+	}
+	nesting = pMutex->nesting;
+	
+	err = kos_swiCondWait(pCond, pMutex, timeout);
+	
+	// a timed out or deleted waiter was never moved onto the mutex
+	if ((OS_ERR_TIMEOUT == err) || (OS_ERR_DELETED == err))
+	{
+		kos_MutexLock(pMutex, KOS_WAIT_FOREVER);
+	}
+	
+	while (--nesting)
+	{
+		kos_MutexLock(pMutex, KOS_WAIT_FOREVER);
+	}
+	
+	return err;
+}
+
+/**** End Public Functions ****/
@@ -19,51 +19,53 @@
 #include "safe_strings.h"
 #include "init.h"
 #include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
 
 #include "printf.h"
 
 //--------------------------------------------------------------
 // external functions
 
-extern void TimerTickISR(void);
+extern KOS_RAMFUNC void TimerTickISR(void);
 
-extern void Restore_Context(void);
+extern KOS_RAMFUNC void kos_PendISR(void);
 
-extern uint32_t InterruptsDisable(void);
-extern void InterruptsRestore(uint32_t cpsr);
-extern void InterruptsEnable(uint32_t cpsr);
+extern KOS_RAMFUNC void Restore_Context(void);
+
+extern uint32_t kos_swiCreateThread(threadCreateArgs_t *pArgs);
 
 extern void TestISR(void);
 
 //--------------------------------------------------------------
 // defines
 
-#define KOS_MAX_THREAD_NAME_LEN 12
 #define KOS_MAX_THREADS 12
 
 #define KOS_TICKS_PER_SEC 100
 
-//--------------------------------------------------------------
-// typedefs
-
-typedef enum threadState_t
-{
-	thread_active = 0,
-	thread_ready,
-	thread_waiting
-}threadState_t;
+#define  ARM_MODE_ARM           0x00000000
+#define  ARM_MODE_THUMB         0x00000020
 
 
-typedef struct threadTCB_t {
-	volatile KOS_STK *stack; // must be first in TCB
-	uint32_t pri;
-	uint32_t id;
-	threadState_t state;
-	char	name[KOS_MAX_THREAD_NAME_LEN];
-	uint32_t stackSize;
-	struct threadTCB_t *pNext;
-}threadTCB_t, *pthreadTCB_t;
+#define ARM_MODE_USER   0x10      // Normal User Mode                              
+#define ARM_MODE_FIQ    0x11      // FIQ Fast Interrupts Mode                     
+#define ARM_MODE_IRQ    0x12      // IRQ Standard Interrupts Mode                 
+#define ARM_MODE_SVC    0x13      // Supervisor Interrupts Mode                   
+#define ARM_MODE_ABORT  0x17      // Abort Processing memory Faults Mode          
+#define ARM_MODE_UNDEF  0x1B      // Undefined Instructions Mode                  
+#define ARM_MODE_SYS    0x1F      // System Running in Priviledged Operating Mode 
+#define ARM_MODE_MASK   0x1F
 
+#if KOS_USE_HOOKS
+#define KOS_HOOK_SWITCH_OUT(pOld, pNew)	do { if (kos_hookSwitchOut) kos_hookSwitchOut((pOld), (pNew)); } while (0)
+#define KOS_HOOK_SWITCH_IN(pOld, pNew)	do { if (kos_hookSwitchIn) kos_hookSwitchIn((pOld), (pNew)); } while (0)
+#define KOS_HOOK_CREATE(pThread)		do { if (kos_hookCreate) kos_hookCreate((pThread)); } while (0)
+#else
+#define KOS_HOOK_SWITCH_OUT(pOld, pNew)	do {} while (0)
+#define KOS_HOOK_SWITCH_IN(pOld, pNew)	do {} while (0)
+#define KOS_HOOK_CREATE(pThread)		do {} while (0)
+#endif
 
 
 //--------------------------------------------------------------
@@ -73,6 +75,10 @@ threadTCB_t *kos_threadCurr = 0;
 
 threadTCB_t *kos_threadList[KOS_MAX_PRIORITIES] = {0};
 
+// set by the kernel when kos_threadCurr must give up the CPU at the end
+// of the current SWI, cleared by kos_ScheduleNext
+volatile uint32_t kos_switchPending = FALSE;
+
 //--------------------------------------------------------------
 // file local variables
 
@@ -80,19 +86,33 @@ static uint8_t kos_threadIdInc = 0;
 
 static BOOL kos_initialized = FALSE;
 
-static uint32_t globalTime = 0;
+static volatile uint32_t globalTime = 0;
+
+// threads sleeping or waiting with a timeout, linked through pDelayNext
+static threadTCB_t *kos_delayList = 0;
+
+#if KOS_USE_HOOKS
+static kosSwitchHook_t *kos_hookSwitchOut = 0;
+static kosSwitchHook_t *kos_hookSwitchIn = 0;
+static kosCreateHook_t *kos_hookCreate = 0;
+#endif
 
 //--------------------------------------------------------------
 // local function prototypes
 //static void OutPutThreadStates(void);
 static void kos_IdleThread(void *pData);
+static void kos_PriInherit(threadTCB_t *pOwner, uint32_t pri);
+static KOS_RAMFUNC void kos_PriRestore(threadTCB_t *pOwner);
+static KOS_RAMFUNC uint32_t kos_OwnerPri(threadTCB_t *pThread);
 static void Tmr_TickInit (void);
-static uint32_t kos_InitThreadStack( KOS_STK **ppStk, uint32_t size, threadfunc_t *pFunc, void *pVoid);
+static void kos_PendInit(void);
+static uint32_t kos_InitThreadStack( KOS_STK **ppStk, uint32_t size, threadfunc_t *pFunc, void *pVoid, uint32_t mode);
 
 //--------------------------------------------------------------
 
-void kos_TimerTick(void);
-void kos_ScheduleNext(void);
+KOS_RAMFUNC void kos_TimerTick(void);
+KOS_RAMFUNC void kos_PendService(void);
+KOS_RAMFUNC void kos_ScheduleNext(void);
 
 
 //--------------------------------------------------------------
@@ -152,23 +172,98 @@ static void Tmr_TickInit (void)
 }
 
 
+/**
+ * Initializes the kernel pend interrupt.
+ * 
+ * kos_PostFromISR raises the VIC software interrupt on channel 1. At the
+ * lowest vector priority it runs once the posting ISR has returned, so
+ * requests from ISRs are handled at once instead of at the next tick.
+ * 
+ * Local to this file, called only by the OS.
+ */
+static void kos_PendInit(void)
+{
+    P_VIC_REGS->IntSelect = P_VIC_REGS->IntSelect & ~(1<<VIC_CH1_SOFTINT);	// IRQ, not FIQ
+    P_VIC_REGS->VectAddr1 = kos_PendISR;
+    P_VIC_REGS->VectPriority1 = VIC_VECT_PRIORITY_LOWEST;
+    P_VIC_REGS->SoftIntClear = (1<<VIC_CH1_SOFTINT);
+    P_VIC_REGS->IntEnable = (1<<VIC_CH1_SOFTINT);
+}
+
+
 /**
  * kos_TimerTick increments OS clock and resets the timer interrupts.
+ * 
+ * Wakes the threads whose delay has run out, runs the requests posted
+ * by ISRs since the last tick and moves the current thread to the back
+ * of its priority round, before kos_ScheduleNext picks the next thread.
  */
-void kos_TimerTick(void)
+KOS_RAMFUNC void kos_TimerTick(void)
 {
+	threadTCB_t *pThread = kos_delayList;
+	threadTCB_t *pNext;
+	uint32_t result;
+	
 	globalTime++;
 	P_TIMER0_REGS->IR = 1;	// reset timer interrupt
 	P_VIC_REGS->Address = (pfunction_t)0xFF; // reset vic
-	//do something else?
+	
+	while (pThread)
+	{
+		pNext = pThread->pDelayNext;
+		if (1 == pThread->delay)
+		{
+			// a sleep ends normally, a wait on a kernel object or a notification times out
+			result = pThread->pWaitList ? OS_ERR_TIMEOUT : OS_NO_ERR;
+			if (pThread->notifyState & KOS_NOTIFY_STATE_WAITING)
+			{
+				pThread->notifyState &= ~KOS_NOTIFY_STATE_WAITING;
+				result = OS_ERR_TIMEOUT;
+			}
+			kos_ThreadWake(pThread, result);
+		}
+		else
+		{
+			pThread->delay--;
+		}
+		pThread = pNext;
+	}
+	
+	kos_PostDrain();
+	
+	// time slice, only if the current thread is still at the head of its round
+	if (kos_threadCurr && (kos_threadList[kos_threadCurr->pri] == kos_threadCurr))
+	{
+		kos_threadList[kos_threadCurr->pri] = kos_threadCurr->pNext;
+	}
+}
+
+/**
+ * Kernel pend, called from kos_PendISR.
+ * 
+ * Clears the software interrupt and runs the requests ISRs have posted,
+ * before kos_ScheduleNext picks the next thread.
+ */
+KOS_RAMFUNC void kos_PendService(void)
+{
+	P_VIC_REGS->SoftIntClear = (1<<VIC_CH1_SOFTINT);
+	P_VIC_REGS->Address = (pfunction_t)0xFF; // reset vic
+	
+	kos_PostDrain();
 }
 
 /**
  * Schedules the next TCB.
+ * 
+ * Picks the thread at the head of the highest priority round. Called
+ * from the tick and from the SWI switch path.
  */
-void kos_ScheduleNext(void)
+KOS_RAMFUNC void kos_ScheduleNext(void)
 {
     uint32_t pri = 0;
+    threadTCB_t *pOld = kos_threadCurr;
+    
+    kos_switchPending = FALSE;
     
     // last array element must be idle thread so it will never go out of bounds
     // bigger problems if there is no idle thread
@@ -177,9 +272,20 @@ void kos_ScheduleNext(void)
         pri++;
     }
     
-    kos_threadList[pri] = kos_threadList[pri]->pNext;
-    
-	kos_threadCurr =  kos_threadList[pri];
+    if (pOld != kos_threadList[pri])
+    {
+        KOS_HOOK_SWITCH_OUT(pOld, kos_threadList[pri]);
+        
+        if (pOld && (thread_active == pOld->state))
+        {
+            pOld->state = thread_ready;
+        }
+        
+        kos_threadCurr =  kos_threadList[pri];
+        kos_threadCurr->state = thread_active;
+        
+        KOS_HOOK_SWITCH_IN(pOld, kos_threadCurr);
+    }
 }
 
 #define STACK_SIZE_IDLE 	(200+sizeof(threadTCB_t))
@@ -206,41 +312,547 @@ static void kos_IdleThread(void *pData)
 }
 
 
-/**** Public Functions ****/
+/**** Kernel Functions ****/
 
 /*
- * Initialize the OS. Documented in os_core.h
+ * Add a thread to the back of its priority round. Documented in os_kernel.h
  */
-uint32_t kos_InitOS(void)
+KOS_RAMFUNC void kos_ReadyInsert(threadTCB_t *pThread)
 {
-	uint32_t err = OS_NO_ERR;
+	threadTCB_t *pHead = kos_threadList[pThread->pri];
 	
-	kos_initialized = TRUE;
+	pThread->state = thread_ready;
 	
-	err = kos_CreateThread( KOS_LOWEST_PRIORITY, "Idle Thread", threadStackIdle, STACK_SIZE_IDLE, kos_IdleThread, 0);
+	if (0 == pHead)
+	{
+		kos_threadList[pThread->pri] = pThread;
+		pThread->pNext = pThread;
+		pThread->pPrev = pThread;
+	}
+	else
+	{
+		// the head runs next, so the back of the round is just before it
+		pThread->pNext = pHead;
+		pThread->pPrev = pHead->pPrev;
+		pHead->pPrev->pNext = pThread;
+		pHead->pPrev = pThread;
+	}
 	
-	if (OS_NO_ERR!=err)
+	if (kos_threadCurr && (pThread->pri < kos_threadCurr->pri))
 	{
-		kos_initialized = FALSE;
-		return err;
+		kos_switchPending = TRUE;
 	}
+}
+
+/*
+ * Take a thread off its priority round. Documented in os_kernel.h
+ */
+KOS_RAMFUNC void kos_ReadyRemove(threadTCB_t *pThread)
+{
+	uint32_t pri = pThread->pri;
 	
-	return err;
+	if (pThread->pNext == pThread)
+	{
+		kos_threadList[pri] = 0;
+	}
+	else
+	{
+		pThread->pPrev->pNext = pThread->pNext;
+		pThread->pNext->pPrev = pThread->pPrev;
+		if (kos_threadList[pri] == pThread)
+		{
+			kos_threadList[pri] = pThread->pNext;
+		}
+	}
+	pThread->pNext = 0;
+	pThread->pPrev = 0;
+	
+	pThread->state = thread_waiting;
+	
+	if (pThread == kos_threadCurr)
+	{
+		kos_switchPending = TRUE;
+	}
 }
 
 /*
- * Adds a thread function to the schedular. Documented in os_core.h
+ * Put a thread on the delay list. Documented in os_kernel.h
  */
-uint32_t kos_CreateThread( uint8_t pri, const char* pszName, KOS_STK *stack, uint32_t stk_size, threadfunc_t *pThreadFunc, void *pVoid)
+void kos_DelayInsert(threadTCB_t *pThread, uint32_t ticks)
+{
+	pThread->delay = ticks;
+	pThread->pDelayPrev = 0;
+	pThread->pDelayNext = kos_delayList;
+	if (kos_delayList)
+	{
+		kos_delayList->pDelayPrev = pThread;
+	}
+	kos_delayList = pThread;
+}
+
+/*
+ * Take a thread off the delay list. Documented in os_kernel.h
+ */
+KOS_RAMFUNC void kos_DelayRemove(threadTCB_t *pThread)
+{
+	if (pThread->pDelayPrev)
+	{
+		pThread->pDelayPrev->pDelayNext = pThread->pDelayNext;
+	}
+	else
+	{
+		kos_delayList = pThread->pDelayNext;
+	}
+	if (pThread->pDelayNext)
+	{
+		pThread->pDelayNext->pDelayPrev = pThread->pDelayPrev;
+	}
+	pThread->pDelayNext = 0;
+	pThread->pDelayPrev = 0;
+	pThread->delay = 0;
+}
+
+/*
+ * Make a waiting thread ready again. Documented in os_kernel.h
+ */
+KOS_RAMFUNC void kos_ThreadWake(threadTCB_t *pThread, uint32_t result)
+{
+	threadTCB_t *pOwner;
+	
+	if (pThread->delay)
+	{
+		kos_DelayRemove(pThread);
+	}
+	
+	if (pThread->pWaitList)
+	{
+		pOwner = pThread->pWaitList->pOwner;
+		kos_WaitRemove(pThread);
+		
+		// a timed out waiter may be the one the owner inherited from
+		if (pOwner && (pOwner->pri == pThread->pri))
+		{
+			kos_PriRestore(pOwner);
+		}
+	}
+	
+	// the thread resumes from its SWI with result in r0
+	pThread->stack[KOS_FRAME_R0] = result;
+	
+	kos_ReadyInsert(pThread);
+}
+
+/*
+ * Initialize a wait list. Documented in os_kernel.h
+ */
+void kos_WaitListInit(kosWaitList_t *pList)
+{
+	pList->pHead = 0;
+	pList->pOwner = 0;
+	pList->pOwnedNext = 0;
+}
+
+/*
+ * Put a thread on a wait list. Documented in os_kernel.h
+ */
+KOS_RAMFUNC void kos_WaitInsert(kosWaitList_t *pList, threadTCB_t *pThread)
+{
+	threadTCB_t *pPrev = 0;
+	threadTCB_t *pNext = pList->pHead;
+	
+	// behind every waiter of the same or higher priority
+	while (pNext && (pNext->pri <= pThread->pri))
+	{
+		pPrev = pNext;
+		pNext = pNext->pWaitNext;
+	}
+	
+	pThread->pWaitList = pList;
+	pThread->pWaitPrev = pPrev;
+	pThread->pWaitNext = pNext;
+	if (pPrev)
+	{
+		pPrev->pWaitNext = pThread;
+	}
+	else
+	{
+		pList->pHead = pThread;
+	}
+	if (pNext)
+	{
+		pNext->pWaitPrev = pThread;
+	}
+}
+
+/*
+ * Take a thread off the wait list it is blocked on. Documented in os_kernel.h
+ */
+KOS_RAMFUNC void kos_WaitRemove(threadTCB_t *pThread)
+{
+	if (pThread->pWaitPrev)
+	{
+		pThread->pWaitPrev->pWaitNext = pThread->pWaitNext;
+	}
+	else
+	{
+		pThread->pWaitList->pHead = pThread->pWaitNext;
+	}
+	if (pThread->pWaitNext)
+	{
+		pThread->pWaitNext->pWaitPrev = pThread->pWaitPrev;
+	}
+	pThread->pWaitList = 0;
+	pThread->pWaitNext = 0;
+	pThread->pWaitPrev = 0;
+}
+
+/*
+ * Block kos_threadCurr on a kernel object. Documented in os_kernel.h
+ */
+uint32_t kos_WaitBlock(kosWaitList_t *pList, uint32_t timeout)
+{
+	threadTCB_t *pThread = kos_threadCurr;
+	
+	if (KOS_NO_WAIT == timeout)
+	{
+		return OS_ERR_TIMEOUT;
+	}
+	
+	// main cannot block, it is not a thread
+	if (0 == pThread)
+	{
+		return OS_ERR;
+	}
+	
+	kos_ReadyRemove(pThread);
+	kos_WaitInsert(pList, pThread);
+	if (KOS_WAIT_FOREVER != timeout)
+	{
+		kos_DelayInsert(pThread, timeout);
+	}
+	
+	if (pList->pOwner)
+	{
+		kos_PriInherit(pList->pOwner, pThread->pri);
+	}
+	
+	// replaced in the saved frame by kos_ThreadWake
+	return OS_ERR_TIMEOUT;
+}
+
+/*
+ * Wake the highest priority thread on a wait list. Documented in os_kernel.h
+ */
+threadTCB_t *kos_WaitWakeOne(kosWaitList_t *pList, uint32_t result)
+{
+	threadTCB_t *pThread = pList->pHead;
+	
+	if (pThread)
+	{
+		kos_ThreadWake(pThread, result);
+	}
+	
+	return pThread;
+}
+
+/*
+ * Wake every thread on a wait list. Documented in os_kernel.h
+ */
+void kos_WaitWakeAll(kosWaitList_t *pList, uint32_t result)
+{
+	while (pList->pHead)
+	{
+		kos_ThreadWake(pList->pHead, result);
+	}
+}
+
+/*
+ * Move a blocked thread to another wait list. Documented in os_kernel.h
+ */
+void kos_WaitRequeue(threadTCB_t *pThread, kosWaitList_t *pList)
+{
+	threadTCB_t *pOwner = pThread->pWaitList->pOwner;
+	
+	kos_WaitRemove(pThread);
+	if (pThread->delay)
+	{
+		kos_DelayRemove(pThread);
+	}
+	if (pOwner && (pOwner->pri == pThread->pri))
+	{
+		kos_PriRestore(pOwner);
+	}
+	
+	kos_WaitInsert(pList, pThread);
+	if (pList->pOwner)
+	{
+		kos_PriInherit(pList->pOwner, pThread->pri);
+	}
+}
+
+/*
+ * Move blocked threads to another wait list. Documented in os_kernel.h
+ */
+void kos_WaitSplice(kosWaitList_t *pFrom, kosWaitList_t *pTo, void *pWaitData)
+{
+	threadTCB_t *pThread = pFrom->pHead;
+	threadTCB_t *pNext;
+	threadTCB_t *pPrev = 0;
+	threadTCB_t *pAt = pTo->pHead;
+	
+	// each thread moved goes after the last, so pAt only moves forward
+	while (pThread)
+	{
+		pNext = pThread->pWaitNext;
+		if (pWaitData && (pThread->pWaitData != pWaitData))
+		{
+			pThread = pNext;
+			continue;
+		}
+		
+		kos_WaitRemove(pThread);
+		if (pThread->delay)
+		{
+			kos_DelayRemove(pThread);
+		}
+		
+		while (pAt && (pAt->pri <= pThread->pri))
+		{
+			pPrev = pAt;
+			pAt = pAt->pWaitNext;
+		}
+		
+		pThread->pWaitList = pTo;
+		pThread->pWaitPrev = pPrev;
+		pThread->pWaitNext = pAt;
+		if (pPrev)
+		{
+			pPrev->pWaitNext = pThread;
+		}
+		else
+		{
+			pTo->pHead = pThread;
+		}
+		if (pAt)
+		{
+			pAt->pWaitPrev = pThread;
+		}
+		pPrev = pThread;
+		
+		pThread = pNext;
+	}
+	
+	if (pFrom->pOwner)
+	{
+		kos_PriRestore(pFrom->pOwner);
+	}
+	if (pTo->pOwner && pTo->pHead)
+	{
+		kos_PriInherit(pTo->pOwner, pTo->pHead->pri);
+	}
+}
+
+/*
+ * Change the running priority of a thread. Documented in os_kernel.h
+ */
+KOS_RAMFUNC void kos_ThreadSetPri(threadTCB_t *pThread, uint32_t pri)
+{
+	threadState_t state = pThread->state;
+	kosWaitList_t *pList = pThread->pWaitList;
+	
+	if (pri == pThread->pri)
+	{
+		return;
+	}
+	
+	if (pThread->pNext)
+	{
+		// ready or running, kos_ReadyRemove pends a switch for kos_threadCurr
+		kos_ReadyRemove(pThread);
+		pThread->pri = pri;
+		kos_ReadyInsert(pThread);
+		pThread->state = state;
+		
+		// a boost or unboost must not cost the running thread its slice
+		if (pThread == kos_threadCurr)
+		{
+			kos_threadList[pri] = pThread;
+		}
+	}
+	else if (pList)
+	{
+		kos_WaitRemove(pThread);
+		pThread->pri = pri;
+		kos_WaitInsert(pList, pThread);
+	}
+	else
+	{
+		// sleeping
+		pThread->pri = pri;
+	}
+}
+
+/*
+ * Lend pri to an owner, and on down the chain of owners it is blocked on.
+ */
+static void kos_PriInherit(threadTCB_t *pOwner, uint32_t pri)
+{
+	// stops at a thread already at pri or higher, so a deadlock cycle ends too
+	while (pOwner && (pri < pOwner->pri))
+	{
+		kos_ThreadSetPri(pOwner, pri);
+		pOwner = pOwner->pWaitList ? pOwner->pWaitList->pOwner : 0;
+	}
+}
+
+/*
+ * Drop an owner to the priority it is still entitled to, and on down the
+ * chain of owners it is blocked on.
+ */
+static KOS_RAMFUNC void kos_PriRestore(threadTCB_t *pOwner)
 {
+	uint32_t pri;
+	
+	// stops at a thread whose priority does not change, so a deadlock cycle ends too
+	while (pOwner)
+	{
+		pri = kos_OwnerPri(pOwner);
+		if (pri == pOwner->pri)
+		{
+			break;
+		}
+		kos_ThreadSetPri(pOwner, pri);
+		pOwner = pOwner->pWaitList ? pOwner->pWaitList->pOwner : 0;
+	}
+}
+
+/*
+ * Priority a thread is entitled to, base or the highest waiter on what it owns.
+ */
+static KOS_RAMFUNC uint32_t kos_OwnerPri(threadTCB_t *pThread)
+{
+	uint32_t pri = pThread->basePri;
+	kosWaitList_t *pList;
+	
+	// wait lists are in priority order, so only the heads matter
+	for (pList = pThread->pOwned; pList; pList = pList->pOwnedNext)
+	{
+		if (pList->pHead && (pList->pHead->pri < pri))
+		{
+			pri = pList->pHead->pri;
+		}
+	}
+	
+	return pri;
+}
+
+/*
+ * Make a thread the owner of a kernel object. Documented in os_kernel.h
+ */
+void kos_OwnerSet(kosWaitList_t *pList, threadTCB_t *pThread)
+{
+	pList->pOwner = pThread;
+	pList->pOwnedNext = pThread->pOwned;
+	pThread->pOwned = pList;
+	
+	if (pList->pHead)
+	{
+		kos_PriInherit(pThread, pList->pHead->pri);
+	}
+}
 
+/*
+ * Release the owner of a kernel object. Documented in os_kernel.h
+ */
+void kos_OwnerClear(kosWaitList_t *pList)
+{
+	threadTCB_t *pOwner = pList->pOwner;
+	kosWaitList_t **ppLink;
+	
+	if (0 == pOwner)
+	{
+		return;
+	}
+	
+	// objects are usually released in the reverse order they were taken,
+	// so this is normally found at the head
+	for (ppLink = &pOwner->pOwned; *ppLink; ppLink = &(*ppLink)->pOwnedNext)
+	{
+		if (*ppLink == pList)
+		{
+			*ppLink = pList->pOwnedNext;
+			break;
+		}
+	}
+	pList->pOwner = 0;
+	pList->pOwnedNext = 0;
+	
+	kos_PriRestore(pOwner);
+}
+
+/*
+ * Copy a block of memory. Documented in os_kernel.h
+ */
+KOS_RAMFUNC void kos_MemCopy(void *pDst, const void *pSrc, uint32_t size)
+{
+	uint8_t *pDst8 = (uint8_t *)pDst;
+	const uint8_t *pSrc8 = (const uint8_t *)pSrc;
+	uint32_t *pDst32;
+	const uint32_t *pSrc32;
+	
+	if (0 == (((uint32_t)pDst ^ (uint32_t)pSrc) & 0x03))
+	{
+		// bytes up to the first word boundary, the same for both
+		while (size && ((uint32_t)pDst8 & 0x03))
+		{
+			*pDst8++ = *pSrc8++;
+			size--;
+		}
+		
+		pDst32 = (uint32_t *)pDst8;
+		pSrc32 = (const uint32_t *)pSrc8;
+		
+		// four words a pass, to cut the loop overhead
+		while (size >= 16)
+		{
+			pDst32[0] = pSrc32[0];
+			pDst32[1] = pSrc32[1];
+			pDst32[2] = pSrc32[2];
+			pDst32[3] = pSrc32[3];
+			pDst32 += 4;
+			pSrc32 += 4;
+			size -= 16;
+		}
+		while (size >= 4)
+		{
+			*pDst32++ = *pSrc32++;
+			size -= 4;
+		}
+		
+		// 1-3 byte tail
+		pDst8 = (uint8_t *)pDst32;
+		pSrc8 = (const uint8_t *)pSrc32;
+	}
+	
+	while (size--)
+	{
+		*pDst8++ = *pSrc8++;
+	}
+}
+
+/*
+ * Create a thread. Kernel side of kos_CreateThread.
+ */
+uint32_t kos_svcCreateThread(threadCreateArgs_t *pArgs)
+{
 	uint32_t err = OS_NO_ERR;
-	//uint8_t i = 0;
-	uint32_t cpsr = 0;
+	KOS_STK *stack = pArgs->stack;
+	uint32_t stk_size = pArgs->stk_size;
+	uint8_t pri = pArgs->pri;
 	
 	threadTCB_t *newTask = (threadTCB_t*)(stack);
 	
-	if ((0 == pThreadFunc) || (0 == stack)) {
+	if ((0 == pArgs->pThreadFunc) || (0 == stack)) {
 		return OS_ERR;
 	}
 	
@@ -261,90 +873,198 @@ uint32_t kos_CreateThread( uint8_t pri, const char* pszName, KOS_STK *stack, uin
 	newTask->id = kos_threadIdInc++;
 	
 	newTask->pri = pri;
+	newTask->basePri = pri;
 	
 	stack = stack+stk_size-1;
-	err = kos_InitThreadStack( &(stack), stk_size-sizeof(threadTCB_t), pThreadFunc, pVoid);
+	err = kos_InitThreadStack( &(stack), stk_size-sizeof(threadTCB_t), pArgs->pThreadFunc, pArgs->pVoid,
+			(pArgs->flags & KOS_THREAD_TRUSTED) ? ARM_MODE_SYS : ARM_MODE_USER);
 	if (err != OS_NO_ERR)
 		return err;
 			
 	newTask->stack = stack;
 	newTask->stackSize = stk_size-sizeof(threadTCB_t);
-		
-	newTask->state = thread_ready;
+	newTask->flags = pArgs->flags;
+	
+	newTask->delay = 0;
+	newTask->pDelayNext = 0;
+	newTask->pDelayPrev = 0;
 	
-	if (0 != pszName)
+	newTask->pWaitList = 0;
+	newTask->pWaitNext = 0;
+	newTask->pWaitPrev = 0;
+	newTask->pWaitData = 0;
+	newTask->pOwned = 0;
+	newTask->notifyValue = 0;
+	newTask->notifyState = 0;
+	
+	if (0 != pArgs->pszName)
 	{
-		strlcpy(newTask->name, pszName, KOS_MAX_THREAD_NAME_LEN);
+		strlcpy(newTask->name, pArgs->pszName, KOS_MAX_THREAD_NAME_LEN);
 	}
 	
-	// add new task to tasks list
+	// add new task to tasks list, the SWI keeps the schedular locked out
+	kos_ReadyInsert(newTask);
 	
-	cpsr = InterruptsDisable(); // must lock out schedular while changing task lists
+	KOS_HOOK_CREATE(newTask);
 	
-	if (0 == kos_threadList[pri])
+	return OS_NO_ERR;
+}
+
+/*
+ * Put the calling thread to sleep. Kernel side of kos_Sleep.
+ */
+uint32_t kos_svcSleep(uint32_t ticks)
+{
+	if (0 == kos_threadCurr)
 	{
-		kos_threadList[pri] = newTask;
-		newTask->pNext = newTask;
+		return OS_ERR;
 	}
-	else
+	
+	if (0 == ticks)
 	{
-		newTask->pNext = kos_threadList[pri]->pNext;
-		kos_threadList[pri]->pNext = newTask;
-		kos_threadList[pri] = newTask;  // list head points to most recently added task
+		return kos_svcYield(OS_NO_ERR);
 	}
 	
-	InterruptsRestore(cpsr);
+	kos_ReadyRemove(kos_threadCurr);
+	kos_DelayInsert(kos_threadCurr, ticks);
 	
 	return OS_NO_ERR;
 }
 
-// some sort of sleep/pause function
-// not busy wait, should it context switch before the tick? no for now.
-uint32_t kos_sleep(uint32_t ticks)
+/*
+ * Switch if one is pending and pass result through. Used by the direct-call
+ * path in os_swi.s, which cannot switch without a SWI.
+ */
+uint32_t kos_svcSwitch(uint32_t result)
 {
-    // put the thread to sleep for a set number of ticks
-    // will have to call timer tick if I want to immediately advance to the next thread
-    // need to create some sort of 'events' list to monitor
-    return 0;
+	return result;
 }
 
-// semaphore/mutex create
+/*
+ * Give up the rest of the time slice. Kernel side of kos_Yield.
+ */
+uint32_t kos_svcYield(uint32_t result)
+{
+	threadTCB_t *pThread = kos_threadCurr;
+	
+	if (pThread && (kos_threadList[pThread->pri] == pThread) && (pThread->pNext != pThread))
+	{
+		kos_threadList[pThread->pri] = pThread->pNext;
+		kos_switchPending = TRUE;
+	}
+	
+	return result;
+}
 
-// semaphore/mutex delete
+/**** End Kernel Functions ****/
 
-// semaphore/mutex wait
 
-// semaphore/mutex trywait
+/**** Public Functions ****/
 
-// semaphore/mutex signal
+/*
+ * Initialize the OS. Documented in os_core.h
+ */
+uint32_t kos_InitOS(void)
+{
+	uint32_t err = OS_NO_ERR;
+	threadCreateArgs_t args = { KOS_LOWEST_PRIORITY, "Idle Thread", threadStackIdle, STACK_SIZE_IDLE, kos_IdleThread, 0, 0 };
+	
+	kos_initialized = TRUE;
+	
+	// called from main in SVC mode, before any thread runs
+	err = kos_svcCreateThread(&args);
+	
+	if (OS_NO_ERR!=err)
+	{
+		kos_initialized = FALSE;
+		return err;
+	}
+	
+	return err;
+}
 
-// semaphore/mutex peek
+/*
+ * Adds a thread function to the schedular. Documented in os_core.h
+ */
+uint32_t kos_CreateThread( uint8_t pri, const char* pszName, KOS_STK *stack, uint32_t stk_size, threadfunc_t *pThreadFunc, void *pVoid)
+{
+	return kos_CreateThreadEx( pri, pszName, stack, stk_size, pThreadFunc, pVoid, 0);
+}
 
+/*
+ * Adds a thread function to the schedular with options. Documented in os_core.h
+ */
+uint32_t kos_CreateThreadEx( uint8_t pri, const char* pszName, KOS_STK *stack, uint32_t stk_size, threadfunc_t *pThreadFunc, void *pVoid, uint32_t flags)
+{
+	// too many arguments for registers, pass them to the kernel in a block
+	threadCreateArgs_t args;
+	
+	args.pri = pri;
+	args.pszName = pszName;
+	args.stack = stack;
+	args.stk_size = stk_size;
+	args.pThreadFunc = pThreadFunc;
+	args.pVoid = pVoid;
+	args.flags = flags;
+	
+	return kos_swiCreateThread(&args);
+}
 
-/**** End Public Functions ****/
+/*
+ * The calling thread. Documented in os_core.h
+ */
+threadTCB_t *kos_ThreadSelf(void)
+{
+	return kos_threadCurr;
+}
+
+/*
+ * Ticks since kos_StartOS. Documented in os_core.h
+ */
+uint32_t kos_TickCount(void)
+{
+	return globalTime;
+}
+
+#if KOS_USE_HOOKS
+/*
+ * Register the switch-out hook. Documented in os_core.h
+ */
+void kos_SetSwitchOutHook(kosSwitchHook_t *pHook)
+{
+	kos_hookSwitchOut = pHook;
+}
 
+/*
+ * Register the switch-in hook. Documented in os_core.h
+ */
+void kos_SetSwitchInHook(kosSwitchHook_t *pHook)
+{
+	kos_hookSwitchIn = pHook;
+}
 
+/*
+ * Register the thread-create hook. Documented in os_core.h
+ */
+void kos_SetCreateHook(kosCreateHook_t *pHook)
+{
+	kos_hookCreate = pHook;
+}
+#endif
 
-#define  ARM_MODE_ARM           0x00000000
-#define  ARM_MODE_THUMB         0x00000020
+
+/**** End Public Functions ****/
 
 
-#define ARM_MODE_USER   0x10      // Normal User Mode                              
-#define ARM_MODE_FIQ    0x11      // FIQ Fast Interrupts Mode                     
-#define ARM_MODE_IRQ    0x12      // IRQ Standard Interrupts Mode                 
-#define ARM_MODE_SVC    0x13      // Supervisor Interrupts Mode                   
-#define ARM_MODE_ABORT  0x17      // Abort Processing memory Faults Mode          
-#define ARM_MODE_UNDEF  0x1B      // Undefined Instructions Mode                  
-#define ARM_MODE_SYS    0x1F      // System Running in Priviledged Operating Mode 
-#define ARM_MODE_MASK   0x1F
 
 /**
  * Initialize a task's stack for a context switch.
  * 
  * This is called from kos_CreateThread to initialize the TCB.
  * It places everything that is needed on the stack to create the initial task context.
+ * The thread starts in mode, ARM_MODE_USER or ARM_MODE_SYS for trusted threads.
  */
-static uint32_t kos_InitThreadStack( KOS_STK **ppStk, uint32_t size, threadfunc_t *pFunc, void *pVoid)
+static uint32_t kos_InitThreadStack( KOS_STK **ppStk, uint32_t size, threadfunc_t *pFunc, void *pVoid, uint32_t mode)
 {
 	
 	if ((0==ppStk) || (0==*ppStk) || (0==pFunc))
@@ -359,7 +1079,7 @@ static uint32_t kos_InitThreadStack( KOS_STK **ppStk, uint32_t size, threadfunc_
 		return OS_ERR;
 	}
 	
-	*pStk		= (uint32_t)pFunc;			// R15 = PC - Task Entry Point
+	*pStk		= (uint32_t)pFunc & ~0x01;	// R15 = PC - Task Entry Point, Thumb bit goes in the CPSR
 	*(--pStk)	= (uint32_t)0x0;			// R14 = lr - should never return from thread
 	*(--pStk)	= (uint32_t)*ppStk;			// R13 = sp - point to original base of stack - all this will be popped in context restore
 	*(--pStk)	= (uint32_t)0x12121212;		// R12
@@ -377,9 +1097,9 @@ static uint32_t kos_InitThreadStack( KOS_STK **ppStk, uint32_t size, threadfunc_
 	*(--pStk)	= (uint32_t)pVoid;			// R00 = argument passed in - in this case what ever void pointer was passed in using CreateThread
 	
     if ((uint32_t)pFunc & 0x01) {								// check if task is ARM or THUMB mode
-        *(--pStk) = (uint32_t)(ARM_MODE_USER|ARM_MODE_THUMB);	// CPSR  (Enable both IRQ and FIQ interrupts, THUMB-mode)
+        *(--pStk) = (uint32_t)(mode|ARM_MODE_THUMB);			// CPSR  (Enable both IRQ and FIQ interrupts, THUMB-mode)
     } else {
-        *(--pStk) = (uint32_t)ARM_MODE_USER;					// CPSR  (Enable both IRQ and FIQ interrupts, ARM-mode)
+        *(--pStk) = (uint32_t)mode;								// CPSR  (Enable both IRQ and FIQ interrupts, ARM-mode)
     }
     
     *ppStk = pStk;
@@ -400,6 +1120,10 @@ static uint32_t kos_InitThreadStack( KOS_STK **ppStk, uint32_t size, threadfunc_
 	}
 	
 	Tmr_TickInit();
+	kos_PendInit();
+	
+	// pick the first thread to run
+	kos_ScheduleNext();
 	
 	// Restore_Context must not be called in sys or usr mode
 	Restore_Context();
@@ -19,6 +19,7 @@
 #include <stddef.h>
 #include "lpc-2378-stk.h"
 #include "error_codes.h"
+#include "os_core.h"
 #include "os_swi.h"
 #include "os_driver.h"
 
@@ -105,28 +106,39 @@ uint32_t kos_RegisterDriver(DriverInfo_t *pDriverInfo)
 uint32_t kos_DriverOpen(DriverHandle_t *Handle, void *pContext, uint32_t Flags)
 {
 	DriverCallData_t callData = {0};
-	uint32_t cnt = gcDriverList;
+	uint32_t i;
+	uint32_t cpsr;
 	
 	if (0==Handle)
 	{
 		return ERR_ARG;
 	}
-	while (cnt--)
+	for (i = 0; i < gcDriverList; i++)
 	{
-		if (0 == strcmp(gpDriverList[gcDriverList]->name, (char*)pContext))
+		if (0 == strcmp(gpDriverList[i]->name, (char*)pContext))
 		{
 			*Handle = 0;
 			
-			callData.type = DRV_OPEN;
-			callData.pFunc = gpDriverList[gcDriverList]->pOpen;
-			callData.arg1 = (uint32_t)pContext;
-			callData.arg2 = Flags;
-			
-			callSWI((uint32_t)&callData, 0, 0, 0);
+			if (kos_IsPrivileged())
+			{
+				// trusted thread, call the driver directly
+				cpsr = InterruptsDisable();
+				callData.arg1 = gpDriverList[i]->pOpen( pContext, Flags );
+				InterruptsRestore(cpsr);
+			}
+			else
+			{
+				callData.type = DRV_OPEN;
+				callData.pFunc = gpDriverList[i]->pOpen;
+				callData.arg1 = (uint32_t)pContext;
+				callData.arg2 = Flags;
+				
+				callSWI((uint32_t)&callData, 0, 0, 0);
+			}
 			
 			if (!CHECK_ERROR(callData.arg1))
 			{
-				*Handle = (DriverHandle_t)gcDriverList;
+				*Handle = (DriverHandle_t)i;
 			}
 			return callData.arg1;
 		}
@@ -139,14 +151,24 @@ uint32_t kos_DriverOpen(DriverHandle_t *Handle, void *pContext, uint32_t Flags)
 uint32_t kos_DriverClose(DriverHandle_t Handle, void *pContext)
 {
 	DriverCallData_t callData = {0};
+	uint32_t cpsr;
 	
-	if (Handle>gcDriverList)
+	if (Handle>=gcDriverList)
 	{
 		return ERR_ARG;
 	}
 	
+	if (kos_IsPrivileged())
+	{
+		// trusted thread, call the driver directly
+		cpsr = InterruptsDisable();
+		callData.arg1 = gpDriverList[Handle]->pClose( pContext );
+		InterruptsRestore(cpsr);
+		return callData.arg1;
+	}
+	
 	callData.type = DRV_CLOSE;
-	callData.pFunc = gpDriverList[gcDriverList]->pClose;
+	callData.pFunc = gpDriverList[Handle]->pClose;
 	callData.arg1 = (uint32_t)pContext;
 	
 	callSWI((uint32_t)&callData, 0, 0, 0);
@@ -159,14 +181,24 @@ uint32_t kos_DriverClose(DriverHandle_t Handle, void *pContext)
 uint32_t kos_DriverRead(DriverHandle_t Handle, void *pContext, void *pBuffer, uint32_t *pByteCount)
 {
 	DriverCallData_t callData = {0};
+	uint32_t cpsr;
 	
-	if (Handle>gcDriverList)
+	if (Handle>=gcDriverList)
 	{
 		return ERR_ARG;
 	}
 	
+	if (kos_IsPrivileged())
+	{
+		// trusted thread, call the driver directly
+		cpsr = InterruptsDisable();
+		callData.arg1 = gpDriverList[Handle]->pRead( pContext, pBuffer, pByteCount );
+		InterruptsRestore(cpsr);
+		return callData.arg1;
+	}
+	
 	callData.type = DRV_READ;
-	callData.pFunc = gpDriverList[gcDriverList]->pRead;
+	callData.pFunc = gpDriverList[Handle]->pRead;
 	callData.arg1 = (uint32_t)pContext;
 	callData.arg2 = (uint32_t)pBuffer;
 	callData.arg3 = (uint32_t)pByteCount;
@@ -180,14 +212,24 @@ uint32_t kos_DriverRead(DriverHandle_t Handle, void *pContext, void *pBuffer, ui
 uint32_t kos_DriverWrite(DriverHandle_t Handle, void *pContext, void *pBuffer, uint32_t *pByteCount)
 {
 	DriverCallData_t callData = {0};
+	uint32_t cpsr;
 	
-	if (Handle>gcDriverList)
+	if (Handle>=gcDriverList)
 	{
 		return ERR_ARG;
 	}
 	
+	if (kos_IsPrivileged())
+	{
+		// trusted thread, call the driver directly
+		cpsr = InterruptsDisable();
+		callData.arg1 = gpDriverList[Handle]->pWrite( pContext, pBuffer, pByteCount );
+		InterruptsRestore(cpsr);
+		return callData.arg1;
+	}
+	
 	callData.type = DRV_WRITE;
-	callData.pFunc = gpDriverList[gcDriverList]->pWrite;
+	callData.pFunc = gpDriverList[Handle]->pWrite;
 	callData.arg1 = (uint32_t)pContext;
 	callData.arg2 = (uint32_t)pBuffer;
 	callData.arg3 = (uint32_t)pByteCount;
@@ -201,14 +243,24 @@ uint32_t kos_DriverWrite(DriverHandle_t Handle, void *pContext, void *pBuffer, u
 uint32_t kos_DriverIoctl(DriverHandle_t Handle, void *pContext, uint32_t Control, void *pBuffer, uint32_t *pByteCount)
 {
 	DriverCallData_t callData = {0};
+	uint32_t cpsr;
 	
-	if (Handle>gcDriverList)
+	if (Handle>=gcDriverList)
 	{
 		return ERR_ARG;
 	}
 	
-	callData.type = DRV_READ;
-	callData.pFunc = gpDriverList[gcDriverList]->pRead;
+	if (kos_IsPrivileged())
+	{
+		// trusted thread, call the driver directly
+		cpsr = InterruptsDisable();
+		callData.arg1 = gpDriverList[Handle]->pIoctl( pContext, Control, pBuffer, pByteCount );
+		InterruptsRestore(cpsr);
+		return callData.arg1;
+	}
+	
+	callData.type = DRV_IOCTL;
+	callData.pFunc = gpDriverList[Handle]->pIoctl;
 	callData.arg1 = (uint32_t)pContext;
 	callData.arg2 = Control;
 	callData.arg3 = (uint32_t)pBuffer;
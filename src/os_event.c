@@ -0,0 +1,262 @@
+/** 
+ * 
+ * \file os_event.c
+ * Event flag groups
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_event.h"
+
+//--------------------------------------------------------------
+// external functions
+
+extern uint32_t kos_swiEventWait(eventWaitArgs_t *pArgs);
+
+//--------------------------------------------------------------
+// local function prototypes
+static uint32_t kos_EventMatch(uint32_t flags, uint32_t mask, uint32_t opts);
+static void kos_EventPostSet(void *pArg);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Non-zero if flags satisfy a wait for mask with opts.
+ */
+static uint32_t kos_EventMatch(uint32_t flags, uint32_t mask, uint32_t opts)
+{
+	if (opts & KOS_EVENT_ALL)
+	{
+		return ((flags & mask) == mask);
+	}
+	
+	return (flags & mask);
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Take event flags for a satisfied wait. Documented in os_kernel.h
+ */
+void kos_EventTake(kosEvent_t *pEvent, uint32_t mask, uint32_t opts, uint32_t *pFlags)
+{
+	if (pFlags)
+	{
+		*pFlags = pEvent->flags;
+	}
+	if (opts & KOS_EVENT_CLEAR)
+	{
+		pEvent->flags &= ~mask;
+	}
+}
+
+/*
+ * Wait for event flags. Kernel side of kos_EventWait.
+ */
+uint32_t kos_svcEventWait(eventWaitArgs_t *pArgs)
+{
+	kosEvent_t *pEvent = pArgs->pEvent;
+	
+	if ((0 == pEvent) || (0 == pArgs->mask))
+	{
+		return ERR_ARG;
+	}
+	
+	kos_EventPostSet(pEvent);
+	
+	if (kos_EventMatch(pEvent->flags, pArgs->mask, pArgs->opts))
+	{
+		kos_EventTake(pEvent, pArgs->mask, pArgs->opts, pArgs->pFlags);
+		return OS_NO_ERR;
+	}
+	
+	if ((KOS_NO_WAIT != pArgs->timeout) && kos_threadCurr)
+	{
+		// the arguments stay on the waiter's stack until it wakes
+		kos_threadCurr->pWaitData = pArgs;
+	}
+	
+	return kos_WaitBlock(&pEvent->waitList, pArgs->timeout);
+}
+
+/*
+ * Set event flags. Kernel side of kos_EventSet.
+ */
+uint32_t kos_svcEventSet(kosEvent_t *pEvent, uint32_t bits)
+{
+	threadTCB_t *pThread;
+	threadTCB_t *pNext;
+	eventWaitArgs_t *pArgs;
+	uint32_t clear = 0;
+	
+	if (0 == pEvent)
+	{
+		return ERR_ARG;
+	}
+	
+	// with any bits an ISR set whose post did not fit in the queue
+	pEvent->flags |= bits | pEvent->isrFlags;
+	pEvent->isrFlags = 0;
+	
+	for (pThread = pEvent->waitList.pHead; pThread; pThread = pNext)
+	{
+		pNext = pThread->pWaitNext;
+		pArgs = (eventWaitArgs_t *)pThread->pWaitData;
+		
+		if (kos_EventMatch(pEvent->flags, pArgs->mask, pArgs->opts))
+		{
+			if (pArgs->pFlags)
+			{
+				*pArgs->pFlags = pEvent->flags;
+			}
+			if (pArgs->opts & KOS_EVENT_CLEAR)
+			{
+				clear |= pArgs->mask;
+			}
+			kos_ThreadWake(pThread, OS_NO_ERR);
+		}
+	}
+	
+	// after the walk, so every waiter woken here saw the same flags
+	pEvent->flags &= ~clear;
+	
+	if (pEvent->pMulti)
+	{
+		kos_MultiFire(&pEvent->pMulti);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Clear event flags. Kernel side of kos_EventClear.
+ */
+uint32_t kos_svcEventClear(kosEvent_t *pEvent, uint32_t bits)
+{
+	if (0 == pEvent)
+	{
+		return ERR_ARG;
+	}
+	
+	// a set from an ISR that is not drained yet happened before this clear,
+	// the rest of it is left for the drain so this wakes nobody
+	pEvent->isrFlags &= ~bits;
+	pEvent->flags &= ~bits;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Delete an event flag group. Kernel side of kos_EventDelete.
+ */
+uint32_t kos_svcEventDelete(kosEvent_t *pEvent)
+{
+	if (0 == pEvent)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_WaitWakeAll(&pEvent->waitList, OS_ERR_DELETED);
+	kos_MultiDelete(&pEvent->pMulti);
+	pEvent->flags = 0;
+	pEvent->isrFlags = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * kos_EventSetFromISR request, run when the post queue is drained, and
+ * first thing in the other event services.
+ */
+static void kos_EventPostSet(void *pArg)
+{
+	kosEvent_t *pEvent = (kosEvent_t *)pArg;
+	uint32_t bits = pEvent->isrFlags;
+	
+	// an earlier post may already have merged the bits
+	if (bits)
+	{
+		pEvent->isrFlags = 0;
+		kos_svcEventSet(pEvent, bits);
+	}
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create an event flag group. Documented in os_event.h
+ */
+uint32_t kos_EventCreate(kosEvent_t *pEvent, uint32_t flags)
+{
+	if (0 == pEvent)
+	{
+		return ERR_ARG;
+	}
+	
+	pEvent->flags = flags;
+	pEvent->isrFlags = 0;
+	kos_WaitListInit(&pEvent->waitList);
+	pEvent->pMulti = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Wait for event flags. Documented in os_event.h
+ */
+uint32_t kos_EventWait(kosEvent_t *pEvent, uint32_t mask, uint32_t opts, uint32_t timeout, uint32_t *pFlags)
+{
+	// too many arguments for registers, pass them to the kernel in a block
+	eventWaitArgs_t args;
+	
+	args.pEvent = pEvent;
+	args.mask = mask;
+	args.opts = opts;
+	args.timeout = timeout;
+	args.pFlags = pFlags;
+	
+	return kos_swiEventWait(&args);
+}
+
+/*
+ * Set event flags from an ISR. Documented in os_event.h
+ */
+KOS_RAMFUNC uint32_t kos_EventSetFromISR(kosEvent_t *pEvent, uint32_t bits)
+{
+	uint32_t cpsr;
+	
+	if (0 == pEvent)
+	{
+		return ERR_ARG;
+	}
+	
+	// only needed if a higher priority IRQ can nest and set bits too
+	cpsr = InterruptsDisable();
+	pEvent->isrFlags |= bits;
+	InterruptsRestore(cpsr);
+	
+	return kos_PostFromISR(kos_EventPostSet, pEvent);
+}
+
+/*
+ * Read the event flags. Documented in os_event.h
+ */
+uint32_t kos_EventPeek(kosEvent_t *pEvent)
+{
+	return pEvent->flags;
+}
+
+/**** End Public Functions ****/
@@ -0,0 +1,483 @@
+/** 
+ * 
+ * \file os_heap.c
+ * Heap
+ *
+ * TLSF. Free blocks are kept on lists by size: the first level is the
+ * power of two, the second splits each power of two into
+ * KOS_HEAP_SL_COUNT ranges. Two bitmaps mark the lists that are not
+ * empty, so the smallest list with a block big enough is found with
+ * two find-first-set operations and no search. The ARM7TDMI has no
+ * CLZ, so those are a fixed five steps in C.
+ *
+ * A block is a size word, with its flags in the low bits, followed by
+ * the memory handed out. A free block also holds its free list links,
+ * and its last word points back at it so the next block can merge with
+ * it on a free. That word is the pPrevPhys of the next block's header.
+ *
+ * The heap runs as kernel services, so calls are serialized with IRQ
+ * disabled for their bounded time.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_heap.h"
+
+#define KOS_HEAP_ALIGN          4
+#define KOS_HEAP_FL_SHIFT       (KOS_HEAP_SL_LOG2 + 2)				// log2 of the smallest power of two with its own first level
+#define KOS_HEAP_FL_COUNT       (KOS_HEAP_FL_MAX - KOS_HEAP_FL_SHIFT + 1)
+#define KOS_HEAP_SMALL_SIZE     (1 << KOS_HEAP_FL_SHIFT)				// smaller blocks share first level 0
+
+#define KOS_HEAP_FREE           0x01								// size flags
+#define KOS_HEAP_PREV_FREE      0x02
+
+#define KOS_HEAP_OVERHEAD       sizeof(uint32_t)					// of an allocated block
+#define KOS_HEAP_PTR_OFFSET     (sizeof(void *) + sizeof(uint32_t))	// header to memory
+#define KOS_HEAP_BLOCK_MIN      (3 * sizeof(void *))				// free links and the next block's pPrevPhys
+#define KOS_HEAP_BLOCK_MAX      (1 << KOS_HEAP_FL_MAX)
+
+//--------------------------------------------------------------
+// typedefs
+
+	// Block header. pPrevPhys is the last word of the block before.
+typedef struct kosHeapBlock_t {
+	struct kosHeapBlock_t *pPrevPhys;	// only valid while that block is free
+	uint32_t size;						// bytes of memory, with KOS_HEAP_xxx flags
+	struct kosHeapBlock_t *pNextFree;	// only while free
+	struct kosHeapBlock_t *pPrevFree;
+}kosHeapBlock_t;
+
+//--------------------------------------------------------------
+// external variables
+
+extern uint8_t __heap_start[];
+extern uint8_t __heap_end[];
+
+//--------------------------------------------------------------
+// file local variables
+
+static kosHeapBlock_t kos_heapNull;		// end of every free list
+
+static uint32_t kos_heapFlMap = 0;
+static uint32_t kos_heapSlMap[KOS_HEAP_FL_COUNT];
+static kosHeapBlock_t *kos_heapLists[KOS_HEAP_FL_COUNT][KOS_HEAP_SL_COUNT];
+
+static kosHeapStats_t kos_heapStats = {0};
+
+//--------------------------------------------------------------
+// local function prototypes
+static int32_t kos_HeapFls(uint32_t word);
+static int32_t kos_HeapFfs(uint32_t word);
+static uint32_t kos_HeapBlockSize(kosHeapBlock_t *pBlock);
+static kosHeapBlock_t *kos_HeapNext(kosHeapBlock_t *pBlock);
+static kosHeapBlock_t *kos_HeapLinkNext(kosHeapBlock_t *pBlock);
+static void kos_HeapMapping(uint32_t size, int32_t *pFl, int32_t *pSl);
+static void kos_HeapListRemove(kosHeapBlock_t *pBlock, int32_t fl, int32_t sl);
+static void kos_HeapRemove(kosHeapBlock_t *pBlock);
+static void kos_HeapInsert(kosHeapBlock_t *pBlock);
+static kosHeapBlock_t *kos_HeapFind(uint32_t size);
+static void kos_HeapMarkFree(kosHeapBlock_t *pBlock);
+static void kos_HeapMarkUsed(kosHeapBlock_t *pBlock);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Index of the highest set bit, -1 for 0.
+ */
+static int32_t kos_HeapFls(uint32_t word)
+{
+	int32_t bit = 31;
+	
+	if (0 == word)
+	{
+		return -1;
+	}
+	
+	if (0 == (word & 0xFFFF0000))
+	{
+		word <<= 16;
+		bit -= 16;
+	}
+	if (0 == (word & 0xFF000000))
+	{
+		word <<= 8;
+		bit -= 8;
+	}
+	if (0 == (word & 0xF0000000))
+	{
+		word <<= 4;
+		bit -= 4;
+	}
+	if (0 == (word & 0xC0000000))
+	{
+		word <<= 2;
+		bit -= 2;
+	}
+	if (0 == (word & 0x80000000))
+	{
+		bit -= 1;
+	}
+	
+	return bit;
+}
+
+/*
+ * Index of the lowest set bit, -1 for 0.
+ */
+static int32_t kos_HeapFfs(uint32_t word)
+{
+	return kos_HeapFls(word & (~word + 1));
+}
+
+/*
+ * Bytes of memory in a block, without its flags.
+ */
+static uint32_t kos_HeapBlockSize(kosHeapBlock_t *pBlock)
+{
+	return pBlock->size & ~(KOS_HEAP_FREE | KOS_HEAP_PREV_FREE);
+}
+
+/*
+ * The block after this one in memory.
+ */
+static kosHeapBlock_t *kos_HeapNext(kosHeapBlock_t *pBlock)
+{
+	return (kosHeapBlock_t *)((uint8_t *)pBlock + KOS_HEAP_PTR_OFFSET + kos_HeapBlockSize(pBlock) - sizeof(void *));
+}
+
+/*
+ * The next block, pointed back at this one.
+ */
+static kosHeapBlock_t *kos_HeapLinkNext(kosHeapBlock_t *pBlock)
+{
+	kosHeapBlock_t *pNext = kos_HeapNext(pBlock);
+	
+	pNext->pPrevPhys = pBlock;
+	
+	return pNext;
+}
+
+/*
+ * The lists a block of size bytes belongs on.
+ */
+static void kos_HeapMapping(uint32_t size, int32_t *pFl, int32_t *pSl)
+{
+	int32_t fl;
+	
+	if (size < KOS_HEAP_SMALL_SIZE)
+	{
+		*pFl = 0;
+		*pSl = size / (KOS_HEAP_SMALL_SIZE / KOS_HEAP_SL_COUNT);
+		return;
+	}
+	
+	fl = kos_HeapFls(size);
+	*pSl = (size >> (fl - KOS_HEAP_SL_LOG2)) ^ KOS_HEAP_SL_COUNT;
+	*pFl = fl - (KOS_HEAP_FL_SHIFT - 1);
+}
+
+/*
+ * Unlink a free block from its list.
+ */
+static void kos_HeapListRemove(kosHeapBlock_t *pBlock, int32_t fl, int32_t sl)
+{
+	kosHeapBlock_t *pPrev = pBlock->pPrevFree;
+	kosHeapBlock_t *pNext = pBlock->pNextFree;
+	
+	pNext->pPrevFree = pPrev;
+	pPrev->pNextFree = pNext;
+	
+	if (kos_heapLists[fl][sl] == pBlock)
+	{
+		kos_heapLists[fl][sl] = pNext;
+		if (&kos_heapNull == pNext)
+		{
+			kos_heapSlMap[fl] &= ~(1U << sl);
+			if (0 == kos_heapSlMap[fl])
+			{
+				kos_heapFlMap &= ~(1U << fl);
+			}
+		}
+	}
+}
+
+/*
+ * Unlink a free block from the list of its size.
+ */
+static void kos_HeapRemove(kosHeapBlock_t *pBlock)
+{
+	int32_t fl;
+	int32_t sl;
+	
+	kos_HeapMapping(kos_HeapBlockSize(pBlock), &fl, &sl);
+	kos_HeapListRemove(pBlock, fl, sl);
+}
+
+/*
+ * Link a free block to the front of the list of its size.
+ */
+static void kos_HeapInsert(kosHeapBlock_t *pBlock)
+{
+	kosHeapBlock_t *pHead;
+	int32_t fl;
+	int32_t sl;
+	
+	kos_HeapMapping(kos_HeapBlockSize(pBlock), &fl, &sl);
+	
+	pHead = kos_heapLists[fl][sl];
+	pBlock->pNextFree = pHead;
+	pBlock->pPrevFree = &kos_heapNull;
+	pHead->pPrevFree = pBlock;
+	kos_heapLists[fl][sl] = pBlock;
+	
+	kos_heapFlMap |= (1U << fl);
+	kos_heapSlMap[fl] |= (1U << sl);
+}
+
+/*
+ * Unlink a free block of at least size bytes, 0 if there is none.
+ */
+static kosHeapBlock_t *kos_HeapFind(uint32_t size)
+{
+	kosHeapBlock_t *pBlock;
+	uint32_t map;
+	int32_t fl;
+	int32_t sl;
+	
+	// round up to the next list, so any block on it is big enough
+	if (size >= KOS_HEAP_SMALL_SIZE)
+	{
+		size += (1U << (kos_HeapFls(size) - KOS_HEAP_SL_LOG2)) - 1;
+	}
+	kos_HeapMapping(size, &fl, &sl);
+	if (fl >= KOS_HEAP_FL_COUNT)
+	{
+		return 0;
+	}
+	
+	map = kos_heapSlMap[fl] & (~0U << sl);
+	if (0 == map)
+	{
+		// first list of a larger power of two
+		map = kos_heapFlMap & (~0U << (fl + 1));
+		if (0 == map)
+		{
+			return 0;
+		}
+		fl = kos_HeapFfs(map);
+		map = kos_heapSlMap[fl];
+	}
+	sl = kos_HeapFfs(map);
+	
+	pBlock = kos_heapLists[fl][sl];
+	kos_HeapListRemove(pBlock, fl, sl);
+	
+	return pBlock;
+}
+
+/*
+ * Flag a block, and the next block's view of it, as free.
+ */
+static void kos_HeapMarkFree(kosHeapBlock_t *pBlock)
+{
+	kos_HeapLinkNext(pBlock)->size |= KOS_HEAP_PREV_FREE;
+	pBlock->size |= KOS_HEAP_FREE;
+}
+
+/*
+ * Flag a block, and the next block's view of it, as used.
+ */
+static void kos_HeapMarkUsed(kosHeapBlock_t *pBlock)
+{
+	kos_HeapNext(pBlock)->size &= ~KOS_HEAP_PREV_FREE;
+	pBlock->size &= ~KOS_HEAP_FREE;
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Allocate memory. Kernel side of kos_Malloc.
+ */
+void *kos_svcHeapAlloc(uint32_t size)
+{
+	kosHeapBlock_t *pBlock = 0;
+	kosHeapBlock_t *pRest;
+	uint32_t blockSize;
+	
+	if (size && (size < KOS_HEAP_BLOCK_MAX))
+	{
+		size = (size + KOS_HEAP_ALIGN - 1) & ~(KOS_HEAP_ALIGN - 1);
+		if (size < KOS_HEAP_BLOCK_MIN)
+		{
+			size = KOS_HEAP_BLOCK_MIN;
+		}
+		pBlock = kos_HeapFind(size);
+	}
+	
+	if (0 == pBlock)
+	{
+		kos_heapStats.fails++;
+		return 0;
+	}
+	
+	// give back the end of the block if it makes a block of its own
+	blockSize = kos_HeapBlockSize(pBlock);
+	if (blockSize >= size + KOS_HEAP_OVERHEAD + KOS_HEAP_BLOCK_MIN)
+	{
+		pRest = (kosHeapBlock_t *)((uint8_t *)pBlock + KOS_HEAP_PTR_OFFSET + size - sizeof(void *));
+		pRest->size = blockSize - (size + KOS_HEAP_OVERHEAD);
+		pBlock->size = size | (pBlock->size & (KOS_HEAP_FREE | KOS_HEAP_PREV_FREE));
+		kos_HeapMarkFree(pRest);
+		kos_HeapLinkNext(pBlock);
+		pRest->size |= KOS_HEAP_PREV_FREE;
+		kos_HeapInsert(pRest);
+	}
+	
+	kos_HeapMarkUsed(pBlock);
+	
+	kos_heapStats.allocs++;
+	kos_heapStats.used += kos_HeapBlockSize(pBlock) + KOS_HEAP_OVERHEAD;
+	if (kos_heapStats.used > kos_heapStats.maxUsed)
+	{
+		kos_heapStats.maxUsed = kos_heapStats.used;
+	}
+	
+	return (uint8_t *)pBlock + KOS_HEAP_PTR_OFFSET;
+}
+
+/*
+ * Free memory. Kernel side of kos_Free.
+ */
+uint32_t kos_svcHeapFree(void *p)
+{
+	kosHeapBlock_t *pBlock;
+	kosHeapBlock_t *pOther;
+	
+	if (0 == p)
+	{
+		return OS_NO_ERR;
+	}
+	
+	if (((uint8_t *)p < __heap_start) || ((uint8_t *)p >= __heap_end))
+	{
+		return ERR_ARG;
+	}
+	
+	pBlock = (kosHeapBlock_t *)((uint8_t *)p - KOS_HEAP_PTR_OFFSET);
+	if (pBlock->size & KOS_HEAP_FREE)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_heapStats.frees++;
+	kos_heapStats.used -= kos_HeapBlockSize(pBlock) + KOS_HEAP_OVERHEAD;
+	
+	kos_HeapMarkFree(pBlock);
+	
+	// merge with the free neighbours, each is one step away
+	if (pBlock->size & KOS_HEAP_PREV_FREE)
+	{
+		pOther = pBlock->pPrevPhys;
+		kos_HeapRemove(pOther);
+		pOther->size += kos_HeapBlockSize(pBlock) + KOS_HEAP_OVERHEAD;
+		pBlock = pOther;
+		kos_HeapLinkNext(pBlock);
+	}
+	
+	pOther = kos_HeapNext(pBlock);
+	if (pOther->size & KOS_HEAP_FREE)
+	{
+		kos_HeapRemove(pOther);
+		pBlock->size += kos_HeapBlockSize(pOther) + KOS_HEAP_OVERHEAD;
+		kos_HeapLinkNext(pBlock);
+	}
+	
+	kos_HeapInsert(pBlock);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Read the heap statistics. Kernel side of kos_HeapStats.
+ */
+uint32_t kos_svcHeapStats(kosHeapStats_t *pStats)
+{
+	if (0 == pStats)
+	{
+		return ERR_ARG;
+	}
+	
+	*pStats = kos_heapStats;
+	
+	return OS_NO_ERR;
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Set up the heap. Documented in os_heap.h
+ */
+uint32_t kos_HeapInit(void)
+{
+	kosHeapBlock_t *pBlock;
+	kosHeapBlock_t *pEnd;
+	uint32_t start = ((uint32_t)__heap_start + KOS_HEAP_ALIGN - 1) & ~(KOS_HEAP_ALIGN - 1);
+	uint32_t size = ((uint32_t)__heap_end & ~(KOS_HEAP_ALIGN - 1)) - start;
+	uint32_t fl;
+	uint32_t sl;
+	
+	// a size word at each end, the last is an empty used block ending the heap
+	if (size < 2 * KOS_HEAP_OVERHEAD + KOS_HEAP_BLOCK_MIN)
+	{
+		return ERR_ARG;
+	}
+	size -= 2 * KOS_HEAP_OVERHEAD;
+	if (size > KOS_HEAP_BLOCK_MAX - KOS_HEAP_ALIGN)
+	{
+		size = KOS_HEAP_BLOCK_MAX - KOS_HEAP_ALIGN;
+	}
+	
+	kos_heapNull.pNextFree = &kos_heapNull;
+	kos_heapNull.pPrevFree = &kos_heapNull;
+	kos_heapFlMap = 0;
+	for (fl = 0; fl < KOS_HEAP_FL_COUNT; fl++)
+	{
+		kos_heapSlMap[fl] = 0;
+		for (sl = 0; sl < KOS_HEAP_SL_COUNT; sl++)
+		{
+			kos_heapLists[fl][sl] = &kos_heapNull;
+		}
+	}
+	
+	// the first header's pPrevPhys is below the heap, and never read
+	pBlock = (kosHeapBlock_t *)(start - sizeof(void *));
+	pBlock->size = size;
+	kos_HeapMarkFree(pBlock);
+	kos_HeapInsert(pBlock);
+	
+	pEnd = kos_HeapNext(pBlock);
+	pEnd->size = 0 | KOS_HEAP_PREV_FREE;
+	
+	kos_heapStats.size = size;
+	kos_heapStats.used = 0;
+	kos_heapStats.maxUsed = 0;
+	kos_heapStats.allocs = 0;
+	kos_heapStats.frees = 0;
+	kos_heapStats.fails = 0;
+	
+	return OS_NO_ERR;
+}
+
+/**** End Public Functions ****/
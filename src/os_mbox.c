@@ -0,0 +1,333 @@
+/** 
+ * 
+ * \file os_mbox.c
+ * Zero-copy mailboxes of reference counted buffers
+ *
+ * The kernel only changes a pool or a reference count with IRQ
+ * disabled, so the ISR calls need to mask only against nested IRQs.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_queue.h"
+#include "os_mbox.h"
+
+//--------------------------------------------------------------
+// local function prototypes
+static void kos_BufFree(kosBuf_t *pBuf);
+static void kos_BufPostWake(void *pArg);
+
+//--------------------------------------------------------------
+// functions
+
+/**** Kernel Functions ****/
+
+/*
+ * Return a buffer with no references left to its pool.
+ */
+static void kos_BufFree(kosBuf_t *pBuf)
+{
+	kosBufPool_t *pPool = pBuf->pPool;
+	threadTCB_t *pThread = pPool->waitList.pHead;
+	
+	// straight to a waiting allocator, it gets the reference
+	if (pThread)
+	{
+		pBuf->refCount = 1;
+		pBuf->length = 0;
+		pBuf->tag = 0;
+		*(kosBuf_t **)pThread->pWaitData = pBuf;
+		kos_ThreadWake(pThread, OS_NO_ERR);
+		return;
+	}
+	
+	pBuf->pNext = pPool->pFree;
+	pPool->pFree = pBuf;
+}
+
+/*
+ * Take a buffer from a pool. Kernel side of kos_BufAlloc.
+ */
+uint32_t kos_svcBufAlloc(kosBufPool_t *pPool, kosBuf_t **ppBuf, uint32_t timeout)
+{
+	kosBuf_t *pBuf;
+	
+	if ((0 == pPool) || (0 == ppBuf))
+	{
+		return ERR_ARG;
+	}
+	
+	// threads an ISR's lost wake left blocked go first
+	kos_BufPostWake(pPool);
+	
+	pBuf = pPool->pFree;
+	if (pBuf)
+	{
+		pPool->pFree = pBuf->pNext;
+		pBuf->pNext = 0;
+		pBuf->refCount = 1;
+		pBuf->length = 0;
+		pBuf->tag = 0;
+		*ppBuf = pBuf;
+		return OS_NO_ERR;
+	}
+	
+	*ppBuf = 0;
+	
+	if (kos_threadCurr)
+	{
+		kos_threadCurr->pWaitData = ppBuf;
+	}
+	
+	return kos_WaitBlock(&pPool->waitList, timeout);
+}
+
+/*
+ * Add a reference to a buffer. Kernel side of kos_BufAddRef.
+ */
+uint32_t kos_svcBufAddRef(kosBuf_t *pBuf)
+{
+	if ((0 == pBuf) || (0 == pBuf->refCount))
+	{
+		return ERR_ARG;
+	}
+	
+	pBuf->refCount++;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Drop a reference to a buffer. Kernel side of kos_BufRelease.
+ */
+uint32_t kos_svcBufRelease(kosBuf_t *pBuf)
+{
+	if ((0 == pBuf) || (0 == pBuf->refCount))
+	{
+		return ERR_ARG;
+	}
+	
+	kos_BufPostWake(pBuf->pPool);
+	
+	if (0 == --pBuf->refCount)
+	{
+		kos_BufFree(pBuf);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * kos_BufReleaseFromISR request, hands the buffers ISRs freed to the
+ * threads waiting for them.
+ */
+static void kos_BufPostWake(void *pArg)
+{
+	kosBufPool_t *pPool = (kosBufPool_t *)pArg;
+	kosBuf_t *pBuf;
+	
+	while (pPool->pFree && pPool->waitList.pHead)
+	{
+		pBuf = pPool->pFree;
+		pPool->pFree = pBuf->pNext;
+		pBuf->pNext = 0;
+		kos_BufFree(pBuf);
+	}
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a buffer pool. Documented in os_mbox.h
+ */
+uint32_t kos_BufPoolCreate(kosBufPool_t *pPool, uint32_t *pStorage, uint32_t bufSize, uint32_t bufCount)
+{
+	uint8_t *pNext = (uint8_t *)pStorage;
+	uint32_t stride = sizeof(kosBuf_t) + KOS_QUEUE_SLOT_SIZE(bufSize);
+	kosBuf_t *pBuf;
+	
+	if ((0 == pPool) || (0 == pStorage) || (0 == bufSize) || (0 == bufCount))
+	{
+		return ERR_ARG;
+	}
+	
+	pPool->pFree = 0;
+	pPool->bufSize = bufSize;
+	kos_WaitListInit(&pPool->waitList);
+	
+	while (bufCount--)
+	{
+		pBuf = (kosBuf_t *)pNext;
+		pBuf->pPool = pPool;
+		pBuf->refCount = 0;
+		pBuf->length = 0;
+		pBuf->tag = 0;
+		pBuf->pNext = pPool->pFree;
+		pPool->pFree = pBuf;
+		pNext += stride;
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Take a buffer from a pool in an ISR. Documented in os_mbox.h
+ */
+KOS_RAMFUNC kosBuf_t *kos_BufAllocFromISR(kosBufPool_t *pPool)
+{
+	uint32_t cpsr;
+	kosBuf_t *pBuf;
+	
+	if (0 == pPool)
+	{
+		return 0;
+	}
+	
+	cpsr = InterruptsDisable();
+	pBuf = pPool->pFree;
+	if (pBuf)
+	{
+		pPool->pFree = pBuf->pNext;
+		pBuf->pNext = 0;
+		pBuf->refCount = 1;
+		pBuf->length = 0;
+		pBuf->tag = 0;
+	}
+	InterruptsRestore(cpsr);
+	
+	return pBuf;
+}
+
+/*
+ * Drop a reference to a buffer in an ISR. Documented in os_mbox.h
+ */
+KOS_RAMFUNC uint32_t kos_BufReleaseFromISR(kosBuf_t *pBuf)
+{
+	uint32_t cpsr;
+	kosBufPool_t *pPool;
+	uint32_t wake = 0;
+	
+	if ((0 == pBuf) || (0 == pBuf->refCount))
+	{
+		return ERR_ARG;
+	}
+	
+	cpsr = InterruptsDisable();
+	if (0 == --pBuf->refCount)
+	{
+		// waking an allocator is the kernel's job, so free it to the list
+		pPool = pBuf->pPool;
+		pBuf->pNext = pPool->pFree;
+		pPool->pFree = pBuf;
+		wake = (0 != pPool->waitList.pHead);
+	}
+	InterruptsRestore(cpsr);
+	
+	// OS_ERR_POST_FULL still leaves the buffer freed
+	if (wake)
+	{
+		return kos_PostFromISR(kos_BufPostWake, pBuf->pPool);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Create a mailbox. Documented in os_mbox.h
+ */
+uint32_t kos_MboxCreate(kosMbox_t *pMbox, uint32_t *pBuffer, uint32_t msgCount)
+{
+	if (0 == pMbox)
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_QueueCreate(&pMbox->queue, pBuffer, sizeof(kosBuf_t *), msgCount);
+}
+
+/*
+ * Post a buffer to a mailbox. Documented in os_mbox.h
+ */
+uint32_t kos_MboxPost(kosMbox_t *pMbox, kosBuf_t *pBuf, uint32_t timeout)
+{
+	uint32_t err;
+	
+	if (0 == pMbox)
+	{
+		return ERR_ARG;
+	}
+	
+	// the receiver's reference
+	err = kos_BufAddRef(pBuf);
+	if (CHECK_ERROR(err))
+	{
+		return err;
+	}
+	
+	// pBuf stays on this stack while the send is blocked
+	err = kos_QueueSend(&pMbox->queue, &pBuf, timeout);
+	if (CHECK_ERROR(err))
+	{
+		kos_BufRelease(pBuf);
+	}
+	
+	return err;
+}
+
+/*
+ * Post a buffer to a mailbox from an ISR. Documented in os_mbox.h
+ */
+KOS_RAMFUNC uint32_t kos_MboxPostFromISR(kosMbox_t *pMbox, kosBuf_t *pBuf)
+{
+	uint32_t cpsr;
+	uint32_t err;
+	
+	if ((0 == pMbox) || (0 == pBuf) || (0 == pBuf->refCount))
+	{
+		return ERR_ARG;
+	}
+	
+	cpsr = InterruptsDisable();
+	pBuf->refCount++;
+	InterruptsRestore(cpsr);
+	
+	err = kos_QueueSendFromISR(&pMbox->queue, &pBuf);
+	
+	// OS_ERR_POST_FULL still queued the buffer, only a full mailbox did not
+	if (OS_ERR_QUEUE_FULL == err)
+	{
+		// the ISR still holds a reference, so this is never the last
+		cpsr = InterruptsDisable();
+		pBuf->refCount--;
+		InterruptsRestore(cpsr);
+	}
+	
+	return err;
+}
+
+/*
+ * Receive a buffer from a mailbox. Documented in os_mbox.h
+ */
+uint32_t kos_MboxReceive(kosMbox_t *pMbox, kosBuf_t **ppBuf, uint32_t timeout)
+{
+	if (0 == pMbox)
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_QueueReceive(&pMbox->queue, ppBuf, timeout);
+}
+
+/**** End Public Functions ****/
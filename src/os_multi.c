@@ -0,0 +1,396 @@
+/** 
+ * 
+ * \file os_multi.c
+ * Waiting on several kernel objects at once
+ *
+ * A thread in kos_WaitMultiple blocks on kos_multiList, which gives it
+ * the usual timeout, and each of its kosWaitObj_t entries is linked
+ * into the pMulti list of its object, highest priority caller first.
+ * When an object has something left to give after its own waiters,
+ * kos_MultiFire offers it to the callers linked there. Unlinking an
+ * entry is O(1).
+ *
+ * The tick knows nothing of the entries, so a caller that times out
+ * unlinks them itself with a second kernel call. Until then the
+ * objects skip it, as it is no longer on kos_multiList.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_sem.h"
+#include "os_queue.h"
+#include "os_event.h"
+#include "os_multi.h"
+
+//--------------------------------------------------------------
+// external functions
+
+extern uint32_t kos_swiWaitMultiple(multiWaitArgs_t *pArgs);
+extern uint32_t kos_swiWaitMultipleCancel(multiWaitArgs_t *pArgs);
+
+//--------------------------------------------------------------
+// file local variables
+
+static kosWaitList_t kos_multiList = {0};
+
+//--------------------------------------------------------------
+// local function prototypes
+static kosWaitObj_t **kos_MultiHead(kosWaitObj_t *pObj);
+static uint32_t kos_MultiReady(kosWaitObj_t *pObj);
+static void kos_MultiTake(kosWaitObj_t *pObj);
+static uint32_t kos_MultiTry(multiWaitArgs_t *pArgs);
+static void kos_MultiLink(kosWaitObj_t *pObj, multiWaitArgs_t *pArgs);
+static void kos_MultiUnlink(kosWaitObj_t *pObj);
+static void kos_MultiWake(multiWaitArgs_t *pArgs, uint32_t result);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * The pMulti list of an entry's object.
+ */
+static kosWaitObj_t **kos_MultiHead(kosWaitObj_t *pObj)
+{
+	switch (pObj->type)
+	{
+	case KOS_WAIT_OBJ_SEM:
+		return &((kosSem_t *)pObj->pObj)->pMulti;
+	case KOS_WAIT_OBJ_QUEUE:
+		return &((kosQueue_t *)pObj->pObj)->pMulti;
+	default:
+		return &((kosEvent_t *)pObj->pObj)->pMulti;
+	}
+}
+
+/*
+ * Non-zero if the entry's object could be taken now.
+ */
+static uint32_t kos_MultiReady(kosWaitObj_t *pObj)
+{
+	uint32_t flags;
+	
+	switch (pObj->type)
+	{
+	case KOS_WAIT_OBJ_SEM:
+		return ((kosSem_t *)pObj->pObj)->count;
+	case KOS_WAIT_OBJ_QUEUE:
+		return ((kosQueue_t *)pObj->pObj)->count;
+	default:
+		flags = ((kosEvent_t *)pObj->pObj)->flags & pObj->mask;
+		if (pObj->opts & KOS_EVENT_ALL)
+		{
+			return (flags == pObj->mask);
+		}
+		return flags;
+	}
+}
+
+/*
+ * Take the entry's object, it must be ready. The object's own code does
+ * it, so the side effects are the same. Nothing here may run
+ * kos_MultiFire, which is on the stack.
+ */
+static void kos_MultiTake(kosWaitObj_t *pObj)
+{
+	switch (pObj->type)
+	{
+	case KOS_WAIT_OBJ_SEM:
+		kos_svcSemWait((kosSem_t *)pObj->pObj, KOS_NO_WAIT);
+		break;
+	case KOS_WAIT_OBJ_QUEUE:
+		kos_QueueTake((kosQueue_t *)pObj->pObj, pObj->pData);
+		break;
+	default:
+		kos_EventTake((kosEvent_t *)pObj->pObj, pObj->mask, pObj->opts, (uint32_t *)pObj->pData);
+		break;
+	}
+}
+
+/*
+ * Take what the call waits for if it can be had now, and set the index.
+ */
+static uint32_t kos_MultiTry(multiWaitArgs_t *pArgs)
+{
+	uint32_t i;
+	
+	if (KOS_WAIT_MULTI_ALL == pArgs->mode)
+	{
+		for (i = 0; i < pArgs->n; i++)
+		{
+			if (!kos_MultiReady(&pArgs->pObjs[i]))
+			{
+				return FALSE;
+			}
+		}
+		for (i = 0; i < pArgs->n; i++)
+		{
+			kos_MultiTake(&pArgs->pObjs[i]);
+		}
+		pArgs->index = pArgs->n;
+		return TRUE;
+	}
+	
+	for (i = 0; i < pArgs->n; i++)
+	{
+		if (kos_MultiReady(&pArgs->pObjs[i]))
+		{
+			kos_MultiTake(&pArgs->pObjs[i]);
+			pArgs->index = i;
+			return TRUE;
+		}
+	}
+	
+	return FALSE;
+}
+
+/*
+ * Link an entry into its object's pMulti list, behind the callers of
+ * the same or higher priority.
+ */
+static void kos_MultiLink(kosWaitObj_t *pObj, multiWaitArgs_t *pArgs)
+{
+	kosWaitObj_t **ppHead = kos_MultiHead(pObj);
+	kosWaitObj_t *pPrev = 0;
+	kosWaitObj_t *pNext = *ppHead;
+	
+	while (pNext && (pNext->pArgs->pThread->pri <= pArgs->pThread->pri))
+	{
+		pPrev = pNext;
+		pNext = pNext->pNext;
+	}
+	
+	pObj->pArgs = pArgs;
+	pObj->pPrev = pPrev;
+	pObj->pNext = pNext;
+	if (pPrev)
+	{
+		pPrev->pNext = pObj;
+	}
+	else
+	{
+		*ppHead = pObj;
+	}
+	if (pNext)
+	{
+		pNext->pPrev = pObj;
+	}
+}
+
+/*
+ * Take an entry off its object's pMulti list, if it is on it.
+ */
+static void kos_MultiUnlink(kosWaitObj_t *pObj)
+{
+	if (0 == pObj->pArgs)
+	{
+		return;
+	}
+	
+	if (pObj->pPrev)
+	{
+		pObj->pPrev->pNext = pObj->pNext;
+	}
+	else
+	{
+		*kos_MultiHead(pObj) = pObj->pNext;
+	}
+	if (pObj->pNext)
+	{
+		pObj->pNext->pPrev = pObj->pPrev;
+	}
+	
+	pObj->pNext = 0;
+	pObj->pPrev = 0;
+	pObj->pArgs = 0;
+}
+
+/*
+ * Unlink all of a call's entries and wake its thread.
+ */
+static void kos_MultiWake(multiWaitArgs_t *pArgs, uint32_t result)
+{
+	uint32_t i;
+	
+	for (i = 0; i < pArgs->n; i++)
+	{
+		kos_MultiUnlink(&pArgs->pObjs[i]);
+	}
+	
+	kos_ThreadWake(pArgs->pThread, result);
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Serve the callers linked to an object. Documented in os_kernel.h
+ */
+void kos_MultiFire(kosWaitObj_t **ppList)
+{
+	kosWaitObj_t *pObj = *ppList;
+	kosWaitObj_t *pNext;
+	multiWaitArgs_t *pArgs;
+	
+	// event entries each have their own mask, so one that is not ready
+	// says nothing of the ones behind it
+	while (pObj)
+	{
+		if (!kos_MultiReady(pObj))
+		{
+			if (KOS_WAIT_OBJ_EVENT != pObj->type)
+			{
+				break;
+			}
+			pObj = pObj->pNext;
+			continue;
+		}
+		
+		// waking the call unlinks its entries, step past any of them
+		pArgs = pObj->pArgs;
+		pNext = pObj->pNext;
+		while (pNext && (pNext->pArgs == pArgs))
+		{
+			pNext = pNext->pNext;
+		}
+		
+		if ((&kos_multiList == pArgs->pThread->pWaitList) && kos_MultiTry(pArgs))
+		{
+			kos_MultiWake(pArgs, OS_NO_ERR);
+		}
+		pObj = pNext;
+	}
+}
+
+/*
+ * Unlink the callers from a deleted object. Documented in os_kernel.h
+ */
+void kos_MultiDelete(kosWaitObj_t **ppList)
+{
+	kosWaitObj_t *pObj;
+	multiWaitArgs_t *pArgs;
+	
+	while (*ppList)
+	{
+		pObj = *ppList;
+		pArgs = pObj->pArgs;
+		
+		if (&kos_multiList == pArgs->pThread->pWaitList)
+		{
+			pArgs->index = pObj - pArgs->pObjs;
+			kos_MultiWake(pArgs, OS_ERR_DELETED);
+		}
+		else
+		{
+			// timed out, the caller has not unlinked yet
+			kos_MultiUnlink(pObj);
+		}
+	}
+}
+
+/*
+ * Wait on several objects. Kernel side of kos_WaitMultiple.
+ */
+uint32_t kos_svcWaitMultiple(multiWaitArgs_t *pArgs)
+{
+	kosWaitObj_t *pObj;
+	uint32_t i;
+	
+	if ((0 == pArgs->pObjs) || (0 == pArgs->n) || (pArgs->mode > KOS_WAIT_MULTI_ALL))
+	{
+		return ERR_ARG;
+	}
+	
+	for (i = 0; i < pArgs->n; i++)
+	{
+		pObj = &pArgs->pObjs[i];
+		if ((0 == pObj->pObj) || (pObj->type < KOS_WAIT_OBJ_SEM) || (pObj->type > KOS_WAIT_OBJ_EVENT) ||
+			((KOS_WAIT_OBJ_QUEUE == pObj->type) && (0 == pObj->pData)) ||
+			((KOS_WAIT_OBJ_EVENT == pObj->type) && (0 == pObj->mask)))
+		{
+			return ERR_ARG;
+		}
+		pObj->pArgs = 0;
+	}
+	
+	if (kos_MultiTry(pArgs))
+	{
+		return OS_NO_ERR;
+	}
+	
+	// nothing to link if the call is not going to block
+	if ((KOS_NO_WAIT == pArgs->timeout) || (0 == kos_threadCurr))
+	{
+		return kos_WaitBlock(&kos_multiList, pArgs->timeout);
+	}
+	
+	pArgs->pThread = kos_threadCurr;
+	for (i = 0; i < pArgs->n; i++)
+	{
+		kos_MultiLink(&pArgs->pObjs[i], pArgs);
+	}
+	
+	kos_threadCurr->pWaitData = pArgs;
+	
+	return kos_WaitBlock(&kos_multiList, pArgs->timeout);
+}
+
+/*
+ * Unlink a timed out call. Kernel side of kos_WaitMultiple.
+ */
+uint32_t kos_svcWaitMultipleCancel(multiWaitArgs_t *pArgs)
+{
+	uint32_t i;
+	
+	for (i = 0; i < pArgs->n; i++)
+	{
+		kos_MultiUnlink(&pArgs->pObjs[i]);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Wait on several objects. Documented in os_multi.h
+ */
+uint32_t kos_WaitMultiple(kosWaitObj_t *pObjs, uint32_t n, uint32_t mode, uint32_t timeout, uint32_t *pIndex)
+{
+	// too many arguments for registers, pass them to the kernel in a block
+	multiWaitArgs_t args;
+	uint32_t err;
+	
+	args.pObjs = pObjs;
+	args.n = n;
+	args.mode = mode;
+	args.timeout = timeout;
+	args.index = n;
+	args.pThread = 0;
+	
+	err = kos_swiWaitMultiple(&args);
+	
+	// the tick woke it, the entries are still linked
+	if ((OS_ERR_TIMEOUT == err) && args.pThread)
+	{
+		kos_swiWaitMultipleCancel(&args);
+	}
+	
+	if (pIndex)
+	{
+		*pIndex = args.index;
+	}
+	
+	return err;
+}
+
+/**** End Public Functions ****/
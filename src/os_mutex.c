@@ -0,0 +1,142 @@
+/** 
+ * 
+ * \file os_mutex.c
+ * Mutexes with priority inheritance
+ *
+ * The priority inheritance itself is in the wait list code in os_core.c,
+ * through the mutex's wait list owner.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_mutex.h"
+
+//--------------------------------------------------------------
+// functions
+
+/**** Kernel Functions ****/
+
+/*
+ * Lock a mutex. Kernel side of kos_MutexLock.
+ */
+uint32_t kos_svcMutexLock(kosMutex_t *pMutex, uint32_t timeout)
+{
+	threadTCB_t *pThread = kos_threadCurr;
+	
+	if (0 == pMutex)
+	{
+		return ERR_ARG;
+	}
+	
+	if (0 == pThread)
+	{
+		return OS_ERR;
+	}
+	
+	if (0 == pMutex->waitList.pOwner)
+	{
+		kos_OwnerSet(&pMutex->waitList, pThread);
+		pMutex->nesting = 1;
+		return OS_NO_ERR;
+	}
+	
+	if (pThread == pMutex->waitList.pOwner)
+	{
+		pMutex->nesting++;
+		return OS_NO_ERR;
+	}
+	
+	// lends the caller's priority to the owner
+	return kos_WaitBlock(&pMutex->waitList, timeout);
+}
+
+/*
+ * Unlock a mutex. Kernel side of kos_MutexUnlock.
+ */
+uint32_t kos_svcMutexUnlock(kosMutex_t *pMutex)
+{
+	threadTCB_t *pNext;
+	
+	if (0 == pMutex)
+	{
+		return ERR_ARG;
+	}
+	
+	if ((0 == kos_threadCurr) || (kos_threadCurr != pMutex->waitList.pOwner))
+	{
+		return OS_ERR_NOT_OWNER;
+	}
+	
+	if (--pMutex->nesting)
+	{
+		return OS_NO_ERR;
+	}
+	
+	kos_OwnerClear(&pMutex->waitList);
+	
+	// hand over, so a thread of the old owner's priority cannot take it first
+	pNext = kos_WaitWakeOne(&pMutex->waitList, OS_NO_ERR);
+	if (pNext)
+	{
+		kos_OwnerSet(&pMutex->waitList, pNext);
+		pMutex->nesting = 1;
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Delete a mutex. Kernel side of kos_MutexDelete.
+ */
+uint32_t kos_svcMutexDelete(kosMutex_t *pMutex)
+{
+	if (0 == pMutex)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_WaitWakeAll(&pMutex->waitList, OS_ERR_DELETED);
+	kos_OwnerClear(&pMutex->waitList);
+	pMutex->nesting = 0;
+	
+	return OS_NO_ERR;
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a mutex. Documented in os_mutex.h
+ */
+uint32_t kos_MutexCreate(kosMutex_t *pMutex)
+{
+	if (0 == pMutex)
+	{
+		return ERR_ARG;
+	}
+	
+	pMutex->nesting = 0;
+	kos_WaitListInit(&pMutex->waitList);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Lock without blocking. Documented in os_mutex.h
+ */
+uint32_t kos_MutexTryLock(kosMutex_t *pMutex)
+{
+	return kos_MutexLock(pMutex, KOS_NO_WAIT);
+}
+
+/**** End Public Functions ****/
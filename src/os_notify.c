@@ -0,0 +1,174 @@
+/** 
+ * 
+ * \file os_notify.c
+ * Direct-to-thread notifications
+ *
+ * A thread blocked in kos_NotifyWait is only marked in its own TCB, with
+ * KOS_NOTIFY_STATE_WAITING, and is on no wait list. A timeout puts it
+ * on the delay list like a sleep, and the tick clears the mark. Blocking
+ * and waking are O(1).
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_notify.h"
+
+//--------------------------------------------------------------
+// local function prototypes
+static KOS_RAMFUNC void kos_NotifyApply(threadTCB_t *pThread, uint32_t value, uint32_t action);
+static void kos_NotifyTake(threadTCB_t *pThread, uint32_t *pValue);
+static void kos_NotifyPostWake(void *pArg);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Update a thread's notification value.
+ */
+static KOS_RAMFUNC void kos_NotifyApply(threadTCB_t *pThread, uint32_t value, uint32_t action)
+{
+	switch (action)
+	{
+	case KOS_NOTIFY_INCREMENT:
+		pThread->notifyValue++;
+		break;
+	case KOS_NOTIFY_SET_BITS:
+		pThread->notifyValue |= value;
+		break;
+	default:
+		pThread->notifyValue = value;
+		break;
+	}
+	pThread->notifyState |= KOS_NOTIFY_STATE_PENDING;
+}
+
+/*
+ * Hand the notification value to its thread and start again from 0.
+ * A waiting thread is no longer waiting.
+ */
+static void kos_NotifyTake(threadTCB_t *pThread, uint32_t *pValue)
+{
+	if (pValue)
+	{
+		*pValue = pThread->notifyValue;
+	}
+	pThread->notifyValue = 0;
+	pThread->notifyState = 0;
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Notify a thread. Kernel side of kos_Notify.
+ */
+uint32_t kos_svcNotify(threadTCB_t *pThread, uint32_t value, uint32_t action)
+{
+	if ((0 == pThread) || (action > KOS_NOTIFY_OVERWRITE))
+	{
+		return ERR_ARG;
+	}
+	
+	kos_NotifyApply(pThread, value, action);
+	
+	if (pThread->notifyState & KOS_NOTIFY_STATE_WAITING)
+	{
+		kos_NotifyTake(pThread, (uint32_t *)pThread->pWaitData);
+		kos_ThreadWake(pThread, OS_NO_ERR);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Wait for a notification. Kernel side of kos_NotifyWait.
+ */
+uint32_t kos_svcNotifyWait(uint32_t timeout, uint32_t *pValue)
+{
+	threadTCB_t *pThread = kos_threadCurr;
+	
+	if (0 == pThread)
+	{
+		return OS_ERR;
+	}
+	
+	if (pThread->notifyState & KOS_NOTIFY_STATE_PENDING)
+	{
+		kos_NotifyTake(pThread, pValue);
+		return OS_NO_ERR;
+	}
+	
+	if (KOS_NO_WAIT == timeout)
+	{
+		return OS_ERR_TIMEOUT;
+	}
+	
+	// blocked like a sleep, kos_svcNotify finds it by the mark
+	kos_ReadyRemove(pThread);
+	if (KOS_WAIT_FOREVER != timeout)
+	{
+		kos_DelayInsert(pThread, timeout);
+	}
+	pThread->notifyState |= KOS_NOTIFY_STATE_WAITING;
+	pThread->pWaitData = pValue;
+	
+	// replaced in the saved frame by kos_ThreadWake
+	return OS_ERR_TIMEOUT;
+}
+
+/*
+ * kos_NotifyFromISR request, wakes the thread if it is still waiting.
+ */
+static void kos_NotifyPostWake(void *pArg)
+{
+	threadTCB_t *pThread = (threadTCB_t *)pArg;
+	
+	// a second post for the same thread finds it already woken
+	if ((pThread->notifyState & KOS_NOTIFY_STATE_WAITING) && (pThread->notifyState & KOS_NOTIFY_STATE_PENDING))
+	{
+		kos_NotifyTake(pThread, (uint32_t *)pThread->pWaitData);
+		kos_ThreadWake(pThread, OS_NO_ERR);
+	}
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Notify a thread from an ISR. Documented in os_notify.h
+ */
+KOS_RAMFUNC uint32_t kos_NotifyFromISR(threadTCB_t *pThread, uint32_t value, uint32_t action)
+{
+	uint32_t cpsr;
+	uint32_t wake;
+	
+	if ((0 == pThread) || (action > KOS_NOTIFY_OVERWRITE))
+	{
+		return ERR_ARG;
+	}
+	
+	// the kernel runs with IRQ disabled, masking is for nested IRQs only
+	cpsr = InterruptsDisable();
+	kos_NotifyApply(pThread, value, action);
+	wake = (pThread->notifyState & KOS_NOTIFY_STATE_WAITING);
+	InterruptsRestore(cpsr);
+	
+	if (wake)
+	{
+		return kos_PostFromISR(kos_NotifyPostWake, pThread);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/**** End Public Functions ****/
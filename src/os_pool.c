@@ -0,0 +1,286 @@
+/** 
+ * 
+ * \file os_pool.c
+ * Fixed-block memory pools
+ *
+ * Free blocks are linked through their first word, so allocating and
+ * freeing are O(1) and the pool needs no memory of its own. The kernel
+ * only changes a pool with IRQ disabled, so the ISR calls need to mask
+ * only against nested IRQs.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_pool.h"
+
+//--------------------------------------------------------------
+// local function prototypes
+static KOS_RAMFUNC void *kos_PoolGet(kosPool_t *pPool);
+static KOS_RAMFUNC void kos_PoolPut(kosPool_t *pPool, void *pBlock);
+static KOS_RAMFUNC uint32_t kos_PoolIsBlock(kosPool_t *pPool, void *pBlock);
+static KOS_RAMFUNC uint32_t kos_PoolIsFree(kosPool_t *pPool, void *pBlock);
+static void kos_PoolPostWake(void *pArg);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Unlink a free block, 0 if there is none.
+ */
+static KOS_RAMFUNC void *kos_PoolGet(kosPool_t *pPool)
+{
+	void *pBlock = pPool->pFree;
+	
+	if (0 == pBlock)
+	{
+		pPool->fails++;
+		return 0;
+	}
+	
+	pPool->pFree = *(void **)pBlock;
+	pPool->used++;
+	if (pPool->used > pPool->maxUsed)
+	{
+		pPool->maxUsed = pPool->used;
+	}
+	
+	return pBlock;
+}
+
+/*
+ * Link a block back onto the free list.
+ */
+static KOS_RAMFUNC void kos_PoolPut(kosPool_t *pPool, void *pBlock)
+{
+	*(void **)pBlock = pPool->pFree;
+	pPool->pFree = pBlock;
+	pPool->used--;
+}
+
+/*
+ * Non-zero if a pointer is the start of one of the pool's blocks.
+ */
+static KOS_RAMFUNC uint32_t kos_PoolIsBlock(kosPool_t *pPool, void *pBlock)
+{
+	uint32_t offset;
+	uint32_t index;
+	uint32_t low;
+	uint32_t cross1;
+	uint32_t cross2;
+	
+	if ((0 == pPool) || ((uint8_t *)pBlock < pPool->pStart) || ((uint8_t *)pBlock >= pPool->pEnd))
+	{
+		return FALSE;
+	}
+	
+	// the ARM7TDMI has no divide, and Thumb no long multiply, and the
+	// libgcc ones are not in RAM. The top word of offset * blockRecip
+	// is built from 16 bit halves.
+	offset = (uint8_t *)pBlock - pPool->pStart;
+	low = (offset & 0xFFFF) * (pPool->blockRecip & 0xFFFF);
+	cross1 = (offset >> 16) * (pPool->blockRecip & 0xFFFF);
+	cross2 = (offset & 0xFFFF) * (pPool->blockRecip >> 16);
+	index = (offset >> 16) * (pPool->blockRecip >> 16) + (cross1 >> 16) + (cross2 >> 16) +
+		(((low >> 16) + (cross1 & 0xFFFF) + (cross2 & 0xFFFF)) >> 16);
+	
+	return (index * pPool->blockSize == offset);
+}
+
+/*
+ * Non-zero if a block is already free, as far as KOS_POOL_CHECK looks.
+ */
+static KOS_RAMFUNC uint32_t kos_PoolIsFree(kosPool_t *pPool, void *pBlock)
+{
+#if KOS_POOL_CHECK
+	void *pFree;
+	
+	for (pFree = pPool->pFree; pFree; pFree = *(void **)pFree)
+	{
+		if (pFree == pBlock)
+		{
+			return TRUE;
+		}
+	}
+	
+	return (0 == pPool->used);
+#else
+	return ((0 == pPool->used) || (pBlock == pPool->pFree));
+#endif
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Allocate a block. Kernel side of kos_PoolAlloc.
+ */
+uint32_t kos_svcPoolAlloc(kosPool_t *pPool, void **ppBlock, uint32_t timeout)
+{
+	if ((0 == pPool) || (0 == ppBlock))
+	{
+		return ERR_ARG;
+	}
+	
+	// threads an ISR's lost wake left blocked go first
+	kos_PoolPostWake(pPool);
+	
+	*ppBlock = kos_PoolGet(pPool);
+	if (*ppBlock)
+	{
+		return OS_NO_ERR;
+	}
+	
+	if (kos_threadCurr)
+	{
+		kos_threadCurr->pWaitData = ppBlock;
+	}
+	
+	return kos_WaitBlock(&pPool->waitList, timeout);
+}
+
+/*
+ * Free a block. Kernel side of kos_PoolFree.
+ */
+uint32_t kos_svcPoolFree(kosPool_t *pPool, void *pBlock)
+{
+	threadTCB_t *pThread;
+	
+	if (!kos_PoolIsBlock(pPool, pBlock) || kos_PoolIsFree(pPool, pBlock))
+	{
+		return ERR_ARG;
+	}
+	
+	kos_PoolPostWake(pPool);
+	
+	// straight to a waiting allocator, the block stays used
+	pThread = pPool->waitList.pHead;
+	if (pThread)
+	{
+		*(void **)pThread->pWaitData = pBlock;
+		kos_ThreadWake(pThread, OS_NO_ERR);
+		return OS_NO_ERR;
+	}
+	
+	kos_PoolPut(pPool, pBlock);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * kos_PoolFreeFromISR request, hands the blocks ISRs freed to the
+ * threads waiting for them.
+ */
+static void kos_PoolPostWake(void *pArg)
+{
+	kosPool_t *pPool = (kosPool_t *)pArg;
+	threadTCB_t *pThread;
+	
+	while (pPool->pFree && pPool->waitList.pHead)
+	{
+		pThread = pPool->waitList.pHead;
+		*(void **)pThread->pWaitData = kos_PoolGet(pPool);
+		kos_ThreadWake(pThread, OS_NO_ERR);
+	}
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a memory pool. Documented in os_pool.h
+ */
+uint32_t kos_PoolCreate(kosPool_t *pPool, uint32_t *pStorage, uint32_t blockSize, uint32_t blockCount)
+{
+	uint8_t *pBlock;
+	
+	if ((0 == pPool) || (0 == pStorage) || (0 == blockSize) || (0 == blockCount))
+	{
+		return ERR_ARG;
+	}
+	
+	pPool->pFree = 0;
+	pPool->blockSize = KOS_POOL_BLOCK_SIZE(blockSize);
+	pPool->blockRecip = (0xFFFFFFFF / pPool->blockSize) + 1;
+	pPool->blockCount = blockCount;
+	pPool->pStart = (uint8_t *)pStorage;
+	pPool->pEnd = pPool->pStart + pPool->blockSize * blockCount;
+	pPool->used = blockCount;
+	pPool->maxUsed = 0;
+	pPool->fails = 0;
+	kos_WaitListInit(&pPool->waitList);
+	
+	// last block first, so blocks are handed out in address order
+	pBlock = pPool->pEnd;
+	while (pBlock > pPool->pStart)
+	{
+		pBlock -= pPool->blockSize;
+		kos_PoolPut(pPool, pBlock);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Allocate a block in an ISR. Documented in os_pool.h
+ */
+KOS_RAMFUNC void *kos_PoolAllocFromISR(kosPool_t *pPool)
+{
+	uint32_t cpsr;
+	void *pBlock;
+	
+	if (0 == pPool)
+	{
+		return 0;
+	}
+	
+	cpsr = InterruptsDisable();
+	pBlock = kos_PoolGet(pPool);
+	InterruptsRestore(cpsr);
+	
+	return pBlock;
+}
+
+/*
+ * Free a block in an ISR. Documented in os_pool.h
+ */
+KOS_RAMFUNC uint32_t kos_PoolFreeFromISR(kosPool_t *pPool, void *pBlock)
+{
+	uint32_t cpsr;
+	uint32_t wake;
+	
+	if (!kos_PoolIsBlock(pPool, pBlock))
+	{
+		return ERR_ARG;
+	}
+	
+	// waking an allocator is the kernel's job, so free it to the list
+	cpsr = InterruptsDisable();
+	if (kos_PoolIsFree(pPool, pBlock))
+	{
+		InterruptsRestore(cpsr);
+		return ERR_ARG;
+	}
+	kos_PoolPut(pPool, pBlock);
+	wake = (0 != pPool->waitList.pHead);
+	InterruptsRestore(cpsr);
+	
+	// OS_ERR_POST_FULL still leaves the block freed
+	if (wake)
+	{
+		return kos_PostFromISR(kos_PoolPostWake, pPool);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/**** End Public Functions ****/
@@ -0,0 +1,105 @@
+/** 
+ * 
+ * \file os_post.c
+ * Deferred ISR-to-kernel post queue
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+
+//--------------------------------------------------------------
+// defines
+
+#define KOS_POST_QUEUE_MASK     (KOS_POST_QUEUE_LEN-1)
+
+#if (KOS_POST_QUEUE_LEN & KOS_POST_QUEUE_MASK)
+#error KOS_POST_QUEUE_LEN must be a power of two
+#endif
+
+//--------------------------------------------------------------
+// typedefs
+
+typedef struct postEntry_t {
+	kosPostFunc_t *pFunc;
+	void *pArg;
+}postEntry_t;
+
+//--------------------------------------------------------------
+// file local variables
+
+static postEntry_t kos_postQueue[KOS_POST_QUEUE_LEN];
+
+// head is only written by the producers (ISRs), tail only by the kernel.
+// Both indices run freely and are masked with KOS_POST_QUEUE_MASK on access.
+static volatile uint32_t kos_postHead = 0;
+static volatile uint32_t kos_postTail = 0;
+
+// number of posts dropped because the queue was full
+uint32_t kos_postOverflow = 0;
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Post a kernel request from an ISR. Documented in os_post.h
+ */
+KOS_RAMFUNC uint32_t kos_PostFromISR(kosPostFunc_t *pFunc, void *pArg)
+{
+	uint32_t cpsr;
+	uint32_t head;
+	
+	if (0 == pFunc)
+	{
+		return ERR_ARG;
+	}
+	
+	// only needed if a higher priority IRQ can nest and post too
+	cpsr = InterruptsDisable();
+	
+	head = kos_postHead;
+	if ((head - kos_postTail) >= KOS_POST_QUEUE_LEN)
+	{
+		kos_postOverflow++;
+		InterruptsRestore(cpsr);
+		return OS_ERR_POST_FULL;
+	}
+	
+	kos_postQueue[head & KOS_POST_QUEUE_MASK].pFunc = pFunc;
+	kos_postQueue[head & KOS_POST_QUEUE_MASK].pArg = pArg;
+	
+	kos_postHead = head + 1;	// publish the entry
+	
+	// kos_PendISR drains the queue once the ISRs have returned
+	P_VIC_REGS->SoftInt = (1<<VIC_CH1_SOFTINT);
+	
+	InterruptsRestore(cpsr);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Run every request waiting in the post queue. Documented in os_post.h
+ */
+KOS_RAMFUNC void kos_PostDrain(void)
+{
+	uint32_t tail = kos_postTail;
+	postEntry_t entry;
+	
+	while (tail != kos_postHead)
+	{
+		entry = kos_postQueue[tail & KOS_POST_QUEUE_MASK];
+		
+		tail++;
+		kos_postTail = tail;	// free the slot before running the request
+		
+		entry.pFunc(entry.pArg);
+	}
+}
@@ -0,0 +1,289 @@
+/** 
+ * 
+ * \file os_queue.c
+ * Message queues of fixed-size items
+ *
+ * A thread is only ever blocked on one side: senders wait while the
+ * queue is full, receivers while it is empty. The blocked thread's item
+ * buffer is its pWaitData, so the other side copies straight to or from
+ * it before waking it.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_queue.h"
+
+//--------------------------------------------------------------
+// local function prototypes
+static KOS_RAMFUNC void kos_QueuePut(kosQueue_t *pQueue, const void *pItem);
+static void kos_QueueGet(kosQueue_t *pQueue, void *pItem);
+static void kos_QueueWakeReceivers(kosQueue_t *pQueue);
+static void kos_QueuePostWake(void *pArg);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Copy an item to the back of the queue, there must be room.
+ */
+static KOS_RAMFUNC void kos_QueuePut(kosQueue_t *pQueue, const void *pItem)
+{
+	kos_MemCopy(pQueue->pBuffer + pQueue->head, pItem, pQueue->itemSize);
+	
+	pQueue->head += pQueue->slotSize;
+	if (pQueue->head >= pQueue->bufSize)
+	{
+		pQueue->head = 0;
+	}
+	pQueue->count++;
+}
+
+/*
+ * Copy the item at the front of the queue out, it must not be empty.
+ */
+static void kos_QueueGet(kosQueue_t *pQueue, void *pItem)
+{
+	kos_MemCopy(pItem, pQueue->pBuffer + pQueue->tail, pQueue->itemSize);
+	
+	pQueue->tail += pQueue->slotSize;
+	if (pQueue->tail >= pQueue->bufSize)
+	{
+		pQueue->tail = 0;
+	}
+	pQueue->count--;
+}
+
+/*
+ * Hand queued items to the receivers blocked on an empty queue. They
+ * are only there together if an ISR's wake is still to come.
+ */
+static void kos_QueueWakeReceivers(kosQueue_t *pQueue)
+{
+	threadTCB_t *pThread;
+	
+	while (pQueue->count && pQueue->recvList.pHead)
+	{
+		pThread = pQueue->recvList.pHead;
+		kos_QueueGet(pQueue, pThread->pWaitData);
+		kos_ThreadWake(pThread, OS_NO_ERR);
+	}
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Send an item. Kernel side of kos_QueueSend.
+ */
+uint32_t kos_svcQueueSend(kosQueue_t *pQueue, const void *pItem, uint32_t timeout)
+{
+	threadTCB_t *pThread;
+	
+	if ((0 == pQueue) || (0 == pItem))
+	{
+		return ERR_ARG;
+	}
+	
+	// items an ISR queued go first, even if their post has not been drained
+	kos_QueuePostWake(pQueue);
+	
+	// a receiver still waiting means the queue is empty, hand the item over
+	pThread = pQueue->recvList.pHead;
+	if (pThread)
+	{
+		kos_MemCopy(pThread->pWaitData, pItem, pQueue->itemSize);
+		kos_ThreadWake(pThread, OS_NO_ERR);
+		return OS_NO_ERR;
+	}
+	
+	if (pQueue->count < pQueue->itemCount)
+	{
+		kos_QueuePut(pQueue, pItem);
+		if (pQueue->pMulti)
+		{
+			kos_MultiFire(&pQueue->pMulti);
+		}
+		return OS_NO_ERR;
+	}
+	
+	if (kos_threadCurr)
+	{
+		kos_threadCurr->pWaitData = (void *)pItem;
+	}
+	
+	return kos_WaitBlock(&pQueue->sendList, timeout);
+}
+
+/*
+ * Receive an item. Kernel side of kos_QueueReceive.
+ */
+uint32_t kos_svcQueueReceive(kosQueue_t *pQueue, void *pItem, uint32_t timeout)
+{
+	if ((0 == pQueue) || (0 == pItem))
+	{
+		return ERR_ARG;
+	}
+	
+	// receivers an ISR's lost wake left blocked go first
+	kos_QueueWakeReceivers(pQueue);
+	
+	if (pQueue->count)
+	{
+		kos_QueueTake(pQueue, pItem);
+		return OS_NO_ERR;
+	}
+	
+	if (kos_threadCurr)
+	{
+		kos_threadCurr->pWaitData = pItem;
+	}
+	
+	return kos_WaitBlock(&pQueue->recvList, timeout);
+}
+
+/*
+ * Take the item at the front of a queue. Documented in os_kernel.h
+ */
+void kos_QueueTake(kosQueue_t *pQueue, void *pItem)
+{
+	threadTCB_t *pThread;
+	
+	kos_QueueGet(pQueue, pItem);
+	
+	// a slot is free, take the first blocked sender's item
+	pThread = pQueue->sendList.pHead;
+	if (pThread)
+	{
+		kos_QueuePut(pQueue, pThread->pWaitData);
+		kos_ThreadWake(pThread, OS_NO_ERR);
+	}
+}
+
+/*
+ * Delete a message queue. Kernel side of kos_QueueDelete.
+ */
+uint32_t kos_svcQueueDelete(kosQueue_t *pQueue)
+{
+	if (0 == pQueue)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_WaitWakeAll(&pQueue->sendList, OS_ERR_DELETED);
+	kos_WaitWakeAll(&pQueue->recvList, OS_ERR_DELETED);
+	kos_MultiDelete(&pQueue->pMulti);
+	pQueue->count = 0;
+	pQueue->head = 0;
+	pQueue->tail = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * kos_QueueSendFromISR request, hands the items the ISRs queued to
+ * the receivers waiting for them.
+ */
+static void kos_QueuePostWake(void *pArg)
+{
+	kosQueue_t *pQueue = (kosQueue_t *)pArg;
+	
+	kos_QueueWakeReceivers(pQueue);
+	
+	if (pQueue->count && pQueue->pMulti)
+	{
+		kos_MultiFire(&pQueue->pMulti);
+	}
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a message queue. Documented in os_queue.h
+ */
+uint32_t kos_QueueCreate(kosQueue_t *pQueue, uint32_t *pBuffer, uint32_t itemSize, uint32_t itemCount)
+{
+	if ((0 == pQueue) || (0 == pBuffer) || (0 == itemSize) || (0 == itemCount))
+	{
+		return ERR_ARG;
+	}
+	
+	pQueue->pBuffer = (uint8_t *)pBuffer;
+	pQueue->itemSize = itemSize;
+	pQueue->slotSize = KOS_QUEUE_SLOT_SIZE(itemSize);
+	pQueue->bufSize = pQueue->slotSize * itemCount;
+	pQueue->itemCount = itemCount;
+	pQueue->count = 0;
+	pQueue->head = 0;
+	pQueue->tail = 0;
+	kos_WaitListInit(&pQueue->sendList);
+	kos_WaitListInit(&pQueue->recvList);
+	pQueue->pMulti = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Send an item from an ISR. Documented in os_queue.h
+ */
+KOS_RAMFUNC uint32_t kos_QueueSendFromISR(kosQueue_t *pQueue, const void *pItem)
+{
+	uint32_t cpsr;
+	uint32_t wake;
+	
+	if ((0 == pQueue) || (0 == pItem))
+	{
+		return ERR_ARG;
+	}
+	
+	// the kernel runs with IRQ disabled, so it never sees a half written
+	// item. Masking is only needed if a higher priority IRQ can nest.
+	cpsr = InterruptsDisable();
+	
+	if (pQueue->count >= pQueue->itemCount)
+	{
+		wake = (0 != pQueue->recvList.pHead);
+		InterruptsRestore(cpsr);
+		
+		// full with receivers blocked means an earlier wake was lost
+		if (wake)
+		{
+			kos_PostFromISR(kos_QueuePostWake, pQueue);
+		}
+		return OS_ERR_QUEUE_FULL;
+	}
+	
+	kos_QueuePut(pQueue, pItem);
+	wake = (0 != pQueue->recvList.pHead) || (0 != pQueue->pMulti);
+	
+	InterruptsRestore(cpsr);
+	
+	// nothing for the kernel to do unless a receiver is blocked or linked.
+	// OS_ERR_POST_FULL still leaves the item queued
+	if (wake)
+	{
+		return kos_PostFromISR(kos_QueuePostWake, pQueue);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Number of items in a queue. Documented in os_queue.h
+ */
+uint32_t kos_QueueCount(kosQueue_t *pQueue)
+{
+	return pQueue->count;
+}
+
+/**** End Public Functions ****/
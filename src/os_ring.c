@@ -0,0 +1,183 @@
+/** 
+ * 
+ * \file os_ring.c
+ * Lock-free single producer, single consumer ring buffer
+ *
+ * The data is copied before the index that publishes it is written.
+ * ARM7 has no cache and does not reorder stores, so volatile indices
+ * are enough to keep that order.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_swi.h"
+#include "os_notify.h"
+#include "os_ring.h"
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Create a ring buffer. Documented in os_ring.h
+ */
+uint32_t kos_RingCreate(kosRing_t *pRing, uint8_t *pBuffer, uint32_t size)
+{
+	if ((0 == pRing) || (0 == pBuffer) || (0 == size) || (size & (size-1)))
+	{
+		return ERR_ARG;
+	}
+	
+	pRing->head = 0;
+	pRing->tail = 0;
+	pRing->mask = size - 1;
+	pRing->pBuffer = pBuffer;
+	pRing->pConsumer = 0;
+	pRing->waiting = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Write to a ring buffer. Documented in os_ring.h
+ */
+KOS_RAMFUNC uint32_t kos_RingWrite(kosRing_t *pRing, const void *pData, uint32_t size)
+{
+	uint32_t head = pRing->head;
+	uint32_t room = (pRing->mask + 1) - (head - pRing->tail);
+	uint32_t offset = head & pRing->mask;
+	uint32_t first;
+	
+	if (size > room)
+	{
+		size = room;
+	}
+	if (0 == size)
+	{
+		return 0;
+	}
+	
+	// up to the end of the buffer, then the rest from the start
+	first = (pRing->mask + 1) - offset;
+	if (first > size)
+	{
+		first = size;
+	}
+	kos_MemCopy(pRing->pBuffer + offset, pData, first);
+	kos_MemCopy(pRing->pBuffer, (const uint8_t *)pData + first, size - first);
+	
+	pRing->head = head + size;	// publish
+	
+	// kos_RingWait sets waiting before it checks for data, so the
+	// consumer either sees the new head or is notified here
+	if (pRing->waiting)
+	{
+		pRing->waiting = 0;
+		// sys mode threads and main can take the kernel call, only ISRs post
+		if (kos_InISR())
+		{
+			kos_NotifyFromISR(pRing->pConsumer, 0, KOS_NOTIFY_INCREMENT);
+		}
+		else
+		{
+			kos_Notify(pRing->pConsumer, 0, KOS_NOTIFY_INCREMENT);
+		}
+	}
+	
+	return size;
+}
+
+/*
+ * Read from a ring buffer. Documented in os_ring.h
+ */
+KOS_RAMFUNC uint32_t kos_RingRead(kosRing_t *pRing, void *pData, uint32_t size)
+{
+	uint32_t tail = pRing->tail;
+	uint32_t count = pRing->head - tail;
+	uint32_t offset = tail & pRing->mask;
+	uint32_t first;
+	
+	if (size > count)
+	{
+		size = count;
+	}
+	if (0 == size)
+	{
+		return 0;
+	}
+	
+	first = (pRing->mask + 1) - offset;
+	if (first > size)
+	{
+		first = size;
+	}
+	kos_MemCopy(pData, pRing->pBuffer + offset, first);
+	kos_MemCopy((uint8_t *)pData + first, pRing->pBuffer, size - first);
+	
+	pRing->tail = tail + size;	// free the space
+	
+	return size;
+}
+
+/*
+ * Wait for data in a ring buffer. Documented in os_ring.h
+ */
+uint32_t kos_RingWait(kosRing_t *pRing, uint32_t timeout)
+{
+	uint32_t err = OS_NO_ERR;
+	uint32_t start = kos_TickCount();
+	uint32_t elapsed;
+	uint32_t wait = timeout;
+	
+	pRing->pConsumer = kos_ThreadSelf();
+	
+	while (pRing->head == pRing->tail)
+	{
+		pRing->waiting = 1;
+		
+		// data written before waiting was seen would not notify
+		if (pRing->head != pRing->tail)
+		{
+			pRing->waiting = 0;
+			break;
+		}
+		
+		// a notification left over from a write that raced the check
+		// above wakes this early, then the loop waits out the rest
+		if ((KOS_NO_WAIT != timeout) && (KOS_WAIT_FOREVER != timeout))
+		{
+			elapsed = kos_TickCount() - start;
+			if (elapsed >= timeout)
+			{
+				pRing->waiting = 0;
+				err = OS_ERR_TIMEOUT;
+				break;
+			}
+			wait = timeout - elapsed;
+		}
+		
+		err = kos_NotifyWait(wait, 0);
+		if (CHECK_ERROR(err))
+		{
+			pRing->waiting = 0;
+			break;
+		}
+	}
+	
+	return err;
+}
+
+/*
+ * Bytes waiting in a ring buffer. Documented in os_ring.h
+ */
+uint32_t kos_RingCount(kosRing_t *pRing)
+{
+	return pRing->head - pRing->tail;
+}
@@ -0,0 +1,227 @@
+/** 
+ * 
+ * \file os_rwlock.c
+ * Reader-writer locks
+ *
+ * A writer holding the lock owns both wait lists, so any thread that
+ * blocks behind it lends it its priority through the wait list code in
+ * os_core.c. Readers are only counted, a writer blocked behind them
+ * does not raise them.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_rwlock.h"
+
+//--------------------------------------------------------------
+// local function prototypes
+static void kos_RwGrantWriter(kosRwLock_t *pLock, threadTCB_t *pThread);
+static void kos_RwGrantReaders(kosRwLock_t *pLock);
+
+//--------------------------------------------------------------
+// functions
+
+/**** Kernel Functions ****/
+
+/*
+ * Give the write lock to a thread.
+ */
+static void kos_RwGrantWriter(kosRwLock_t *pLock, threadTCB_t *pThread)
+{
+	kos_OwnerSet(&pLock->writeList, pThread);
+	kos_OwnerSet(&pLock->readList, pThread);
+}
+
+/*
+ * Give the read lock to every blocked reader.
+ */
+static void kos_RwGrantReaders(kosRwLock_t *pLock)
+{
+	while (pLock->readList.pHead)
+	{
+		pLock->readers++;
+		kos_ThreadWake(pLock->readList.pHead, OS_NO_ERR);
+	}
+}
+
+/*
+ * Lock for reading. Kernel side of kos_RwReadLock.
+ */
+uint32_t kos_svcRwReadLock(kosRwLock_t *pLock, uint32_t timeout)
+{
+	if (0 == pLock)
+	{
+		return ERR_ARG;
+	}
+	
+	if (0 == pLock->writeList.pOwner)
+	{
+		// writer preference, queue behind a blocked writer
+		if (0 == pLock->writeList.pHead)
+		{
+			// readers held back by a writer that has since timed out go first
+			kos_RwGrantReaders(pLock);
+			pLock->readers++;
+			return OS_NO_ERR;
+		}
+	}
+	else if (kos_threadCurr == pLock->writeList.pOwner)
+	{
+		return OS_ERR;
+	}
+	
+	return kos_WaitBlock(&pLock->readList, timeout);
+}
+
+/*
+ * Unlock a read lock. Kernel side of kos_RwReadUnlock.
+ */
+uint32_t kos_svcRwReadUnlock(kosRwLock_t *pLock)
+{
+	threadTCB_t *pThread;
+	
+	if (0 == pLock)
+	{
+		return ERR_ARG;
+	}
+	
+	if (0 == pLock->readers)
+	{
+		return OS_ERR_NOT_OWNER;
+	}
+	
+	if (--pLock->readers)
+	{
+		return OS_NO_ERR;
+	}
+	
+	pThread = kos_WaitWakeOne(&pLock->writeList, OS_NO_ERR);
+	if (pThread)
+	{
+		kos_RwGrantWriter(pLock, pThread);
+	}
+	else
+	{
+		// readers held back by a writer that has since timed out
+		kos_RwGrantReaders(pLock);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Lock for writing. Kernel side of kos_RwWriteLock.
+ */
+uint32_t kos_svcRwWriteLock(kosRwLock_t *pLock, uint32_t timeout)
+{
+	if (0 == pLock)
+	{
+		return ERR_ARG;
+	}
+	
+	if (0 == kos_threadCurr)
+	{
+		return OS_ERR;
+	}
+	
+	if ((0 == pLock->writeList.pOwner) && (0 == pLock->readers))
+	{
+		kos_RwGrantWriter(pLock, kos_threadCurr);
+		return OS_NO_ERR;
+	}
+	
+	if (kos_threadCurr == pLock->writeList.pOwner)
+	{
+		return OS_ERR;
+	}
+	
+	return kos_WaitBlock(&pLock->writeList, timeout);
+}
+
+/*
+ * Unlock a write lock. Kernel side of kos_RwWriteUnlock.
+ */
+uint32_t kos_svcRwWriteUnlock(kosRwLock_t *pLock)
+{
+	threadTCB_t *pWriter;
+	threadTCB_t *pReader;
+	
+	if (0 == pLock)
+	{
+		return ERR_ARG;
+	}
+	
+	if ((0 == kos_threadCurr) || (kos_threadCurr != pLock->writeList.pOwner))
+	{
+		return OS_ERR_NOT_OWNER;
+	}
+	
+	kos_OwnerClear(&pLock->writeList);
+	kos_OwnerClear(&pLock->readList);
+	
+	pWriter = pLock->writeList.pHead;
+	pReader = pLock->readList.pHead;
+	
+	if (pWriter && ((0 == pReader) || (pWriter->pri <= pReader->pri)))
+	{
+		kos_WaitWakeOne(&pLock->writeList, OS_NO_ERR);
+		kos_RwGrantWriter(pLock, pWriter);
+	}
+	else
+	{
+		kos_RwGrantReaders(pLock);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Delete a reader-writer lock. Kernel side of kos_RwDelete.
+ */
+uint32_t kos_svcRwDelete(kosRwLock_t *pLock)
+{
+	if (0 == pLock)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_WaitWakeAll(&pLock->writeList, OS_ERR_DELETED);
+	kos_WaitWakeAll(&pLock->readList, OS_ERR_DELETED);
+	kos_OwnerClear(&pLock->writeList);
+	kos_OwnerClear(&pLock->readList);
+	pLock->readers = 0;
+	
+	return OS_NO_ERR;
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a reader-writer lock. Documented in os_rwlock.h
+ */
+uint32_t kos_RwCreate(kosRwLock_t *pLock)
+{
+	if (0 == pLock)
+	{
+		return ERR_ARG;
+	}
+	
+	pLock->readers = 0;
+	kos_WaitListInit(&pLock->writeList);
+	kos_WaitListInit(&pLock->readList);
+	
+	return OS_NO_ERR;
+}
+
+/**** End Public Functions ****/
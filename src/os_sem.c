@@ -0,0 +1,156 @@
+/** 
+ * 
+ * \file os_sem.c
+ * Counting semaphores
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_sem.h"
+
+//--------------------------------------------------------------
+// local function prototypes
+static void kos_SemPostSignal(void *pArg);
+
+//--------------------------------------------------------------
+// functions
+
+/**** Kernel Functions ****/
+
+/*
+ * Wait on a semaphore. Kernel side of kos_SemWait.
+ */
+uint32_t kos_svcSemWait(kosSem_t *pSem, uint32_t timeout)
+{
+	if (0 == pSem)
+	{
+		return ERR_ARG;
+	}
+	
+	if (pSem->count)
+	{
+		pSem->count--;
+		return OS_NO_ERR;
+	}
+	
+	return kos_WaitBlock(&pSem->waitList, timeout);
+}
+
+/*
+ * Signal a semaphore. Kernel side of kos_SemSignal.
+ */
+uint32_t kos_svcSemSignal(kosSem_t *pSem)
+{
+	if (0 == pSem)
+	{
+		return ERR_ARG;
+	}
+	
+	// the count goes straight to the waiter
+	if (kos_WaitWakeOne(&pSem->waitList, OS_NO_ERR))
+	{
+		return OS_NO_ERR;
+	}
+	
+	if (pSem->count >= pSem->maxCount)
+	{
+		return OS_ERR_SEM_OVF;
+	}
+	
+	pSem->count++;
+	
+	if (pSem->pMulti)
+	{
+		kos_MultiFire(&pSem->pMulti);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Delete a semaphore. Kernel side of kos_SemDelete.
+ */
+uint32_t kos_svcSemDelete(kosSem_t *pSem)
+{
+	if (0 == pSem)
+	{
+		return ERR_ARG;
+	}
+	
+	kos_WaitWakeAll(&pSem->waitList, OS_ERR_DELETED);
+	kos_MultiDelete(&pSem->pMulti);
+	pSem->count = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * kos_SemSignalFromISR request, run when the post queue is drained.
+ */
+static void kos_SemPostSignal(void *pArg)
+{
+	kos_svcSemSignal((kosSem_t *)pArg);
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a semaphore. Documented in os_sem.h
+ */
+uint32_t kos_SemCreate(kosSem_t *pSem, uint32_t count, uint32_t maxCount)
+{
+	if ((0 == pSem) || (0 == maxCount) || (count > maxCount))
+	{
+		return ERR_ARG;
+	}
+	
+	pSem->count = count;
+	pSem->maxCount = maxCount;
+	kos_WaitListInit(&pSem->waitList);
+	pSem->pMulti = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Take a count without blocking. Documented in os_sem.h
+ */
+uint32_t kos_SemTryWait(kosSem_t *pSem)
+{
+	return kos_SemWait(pSem, KOS_NO_WAIT);
+}
+
+/*
+ * Signal a semaphore from an ISR. Documented in os_sem.h
+ */
+KOS_RAMFUNC uint32_t kos_SemSignalFromISR(kosSem_t *pSem)
+{
+	if (0 == pSem)
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_PostFromISR(kos_SemPostSignal, pSem);
+}
+
+/*
+ * Read the count of a semaphore. Documented in os_sem.h
+ */
+uint32_t kos_SemPeek(kosSem_t *pSem)
+{
+	return pSem->count;
+}
+
+/**** End Public Functions ****/
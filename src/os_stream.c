@@ -0,0 +1,345 @@
+/** 
+ * 
+ * \file os_stream.c
+ * Stream buffers, byte pipes with a trigger level
+ *
+ * A blocked reader or writer keeps its streamArgs_t in pWaitData. The
+ * kernel moves bytes to and from it as the other side makes progress,
+ * and only wakes a reader once its trigger level is there, so a byte
+ * stream does not cost a switch per byte.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_stream.h"
+
+//--------------------------------------------------------------
+// external functions
+
+extern uint32_t kos_swiStreamWrite(streamArgs_t *pArgs);
+extern uint32_t kos_swiStreamRead(streamArgs_t *pArgs);
+
+//--------------------------------------------------------------
+// local function prototypes
+static KOS_RAMFUNC uint32_t kos_StreamPut(kosStream_t *pStream, const uint8_t *pData, uint32_t size);
+static uint32_t kos_StreamGet(kosStream_t *pStream, uint8_t *pData, uint32_t size);
+static void kos_StreamPump(kosStream_t *pStream);
+static void kos_StreamPostPump(void *pArg);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Copy in as many bytes as fit, returns the number copied.
+ */
+static KOS_RAMFUNC uint32_t kos_StreamPut(kosStream_t *pStream, const uint8_t *pData, uint32_t size)
+{
+	uint32_t first;
+	
+	if (size > (pStream->size - pStream->count))
+	{
+		size = pStream->size - pStream->count;
+	}
+	
+	// up to the end of the buffer, then the rest from the start
+	first = pStream->size - pStream->head;
+	if (first > size)
+	{
+		first = size;
+	}
+	kos_MemCopy(pStream->pBuffer + pStream->head, pData, first);
+	kos_MemCopy(pStream->pBuffer, pData + first, size - first);
+	
+	pStream->head += size;
+	if (pStream->head >= pStream->size)
+	{
+		pStream->head -= pStream->size;
+	}
+	pStream->count += size;
+	
+	return size;
+}
+
+/*
+ * Copy out as many bytes as there are, up to size, returns the number copied.
+ */
+static uint32_t kos_StreamGet(kosStream_t *pStream, uint8_t *pData, uint32_t size)
+{
+	uint32_t first;
+	
+	if (size > pStream->count)
+	{
+		size = pStream->count;
+	}
+	
+	first = pStream->size - pStream->tail;
+	if (first > size)
+	{
+		first = size;
+	}
+	kos_MemCopy(pData, pStream->pBuffer + pStream->tail, first);
+	kos_MemCopy(pData + first, pStream->pBuffer, size - first);
+	
+	pStream->tail += size;
+	if (pStream->tail >= pStream->size)
+	{
+		pStream->tail -= pStream->size;
+	}
+	pStream->count -= size;
+	
+	return size;
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Move bytes between the buffer and the blocked threads until neither
+ * side can make progress. Readers are only served at their trigger level.
+ */
+static void kos_StreamPump(kosStream_t *pStream)
+{
+	threadTCB_t *pThread;
+	streamArgs_t *pArgs;
+	uint32_t need;
+	uint32_t progress;
+	
+	do
+	{
+		progress = 0;
+		
+		pThread = pStream->readList.pHead;
+		if (pThread)
+		{
+			pArgs = (streamArgs_t *)pThread->pWaitData;
+			need = (pArgs->size < pStream->trigger) ? pArgs->size : pStream->trigger;
+			if (pStream->count >= need)
+			{
+				pArgs->done = kos_StreamGet(pStream, pArgs->pData, pArgs->size);
+				kos_ThreadWake(pThread, OS_NO_ERR);
+				progress = 1;
+			}
+		}
+		
+		pThread = pStream->writeList.pHead;
+		if (pThread && (pStream->count < pStream->size))
+		{
+			pArgs = (streamArgs_t *)pThread->pWaitData;
+			pArgs->done += kos_StreamPut(pStream, pArgs->pData + pArgs->done, pArgs->size - pArgs->done);
+			if (pArgs->done == pArgs->size)
+			{
+				kos_ThreadWake(pThread, OS_NO_ERR);
+			}
+			progress = 1;
+		}
+	} while (progress);
+}
+
+/*
+ * Write to a stream buffer. Kernel side of kos_StreamWrite.
+ */
+uint32_t kos_svcStreamWrite(streamArgs_t *pArgs)
+{
+	kosStream_t *pStream = pArgs->pStream;
+	uint32_t n;
+	
+	if ((0 == pStream) || (0 == pArgs->pData))
+	{
+		return ERR_ARG;
+	}
+	
+	// earlier writers are blocked only while the buffer is full, so
+	// there is no one to overtake
+	do
+	{
+		n = kos_StreamPut(pStream, pArgs->pData + pArgs->done, pArgs->size - pArgs->done);
+		pArgs->done += n;
+		kos_StreamPump(pStream);
+	} while (n && (pArgs->done < pArgs->size));
+	
+	if (pArgs->done == pArgs->size)
+	{
+		return OS_NO_ERR;
+	}
+	
+	if (kos_threadCurr)
+	{
+		kos_threadCurr->pWaitData = pArgs;
+	}
+	
+	return kos_WaitBlock(&pStream->writeList, pArgs->timeout);
+}
+
+/*
+ * Read from a stream buffer. Kernel side of kos_StreamRead.
+ */
+uint32_t kos_svcStreamRead(streamArgs_t *pArgs)
+{
+	kosStream_t *pStream = pArgs->pStream;
+	uint32_t need;
+	
+	if ((0 == pStream) || (0 == pArgs->pData))
+	{
+		return ERR_ARG;
+	}
+	
+	if (0 == pArgs->size)
+	{
+		return OS_NO_ERR;
+	}
+	
+	need = (pArgs->size < pStream->trigger) ? pArgs->size : pStream->trigger;
+	if ((KOS_NO_WAIT == pArgs->timeout) && pStream->count)
+	{
+		need = 1;
+	}
+	
+	if (need && (pStream->count >= need))
+	{
+		pArgs->done = kos_StreamGet(pStream, pArgs->pData, pArgs->size);
+		
+		// the room may let blocked writers finish
+		kos_StreamPump(pStream);
+		return OS_NO_ERR;
+	}
+	
+	if (kos_threadCurr)
+	{
+		kos_threadCurr->pWaitData = pArgs;
+	}
+	
+	return kos_WaitBlock(&pStream->readList, pArgs->timeout);
+}
+
+/*
+ * kos_StreamWriteFromISR request, serves the blocked reader.
+ */
+static void kos_StreamPostPump(void *pArg)
+{
+	kos_StreamPump((kosStream_t *)pArg);
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a stream buffer. Documented in os_stream.h
+ */
+uint32_t kos_StreamCreate(kosStream_t *pStream, uint8_t *pBuffer, uint32_t size, uint32_t trigger)
+{
+	if ((0 == pStream) || (0 == pBuffer) || (0 == size) || (0 == trigger) || (trigger > size))
+	{
+		return ERR_ARG;
+	}
+	
+	pStream->pBuffer = pBuffer;
+	pStream->size = size;
+	pStream->count = 0;
+	pStream->head = 0;
+	pStream->tail = 0;
+	pStream->trigger = trigger;
+	kos_WaitListInit(&pStream->readList);
+	kos_WaitListInit(&pStream->writeList);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Write to a stream buffer. Documented in os_stream.h
+ */
+uint32_t kos_StreamWrite(kosStream_t *pStream, const void *pData, uint32_t size, uint32_t timeout)
+{
+	// too many arguments for registers, pass them to the kernel in a block
+	streamArgs_t args;
+	
+	args.pStream = pStream;
+	args.pData = (uint8_t *)pData;
+	args.size = size;
+	args.timeout = timeout;
+	args.done = 0;
+	
+	kos_swiStreamWrite(&args);
+	
+	return args.done;
+}
+
+/*
+ * Write to a stream buffer from an ISR. Documented in os_stream.h
+ */
+KOS_RAMFUNC uint32_t kos_StreamWriteFromISR(kosStream_t *pStream, const void *pData, uint32_t size)
+{
+	uint32_t cpsr;
+	uint32_t n;
+	uint32_t wake = 0;
+	streamArgs_t *pArgs;
+	
+	if ((0 == pStream) || (0 == pData))
+	{
+		return 0;
+	}
+	
+	// the kernel runs with IRQ disabled, masking is for nested IRQs only
+	cpsr = InterruptsDisable();
+	n = kos_StreamPut(pStream, (const uint8_t *)pData, size);
+	
+	// only enter the kernel once the blocked reader's level is reached
+	if (pStream->readList.pHead)
+	{
+		pArgs = (streamArgs_t *)pStream->readList.pHead->pWaitData;
+		wake = (pStream->count >= pStream->trigger) || (pStream->count >= pArgs->size);
+	}
+	InterruptsRestore(cpsr);
+	
+	if (wake)
+	{
+		kos_PostFromISR(kos_StreamPostPump, pStream);
+	}
+	
+	return n;
+}
+
+/*
+ * Read from a stream buffer. Documented in os_stream.h
+ */
+uint32_t kos_StreamRead(kosStream_t *pStream, void *pData, uint32_t size, uint32_t timeout)
+{
+	streamArgs_t args;
+	uint32_t err;
+	
+	args.pStream = pStream;
+	args.pData = (uint8_t *)pData;
+	args.size = size;
+	args.timeout = timeout;
+	args.done = 0;
+	
+	err = kos_swiStreamRead(&args);
+	
+	// timed out below the trigger level, take what is there
+	if ((OS_ERR_TIMEOUT == err) && (KOS_NO_WAIT != timeout))
+	{
+		args.timeout = KOS_NO_WAIT;
+		kos_swiStreamRead(&args);
+	}
+	
+	return args.done;
+}
+
+/*
+ * Bytes waiting in a stream buffer. Documented in os_stream.h
+ */
+uint32_t kos_StreamCount(kosStream_t *pStream)
+{
+	return pStream->count;
+}
+
+/**** End Public Functions ****/
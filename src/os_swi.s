@@ -7,32 +7,290 @@
  * 
  * History:
  * 08 JUN 2008 : Created KLW
+ * 18 OCT 2026 : Dispatch on the SWI number, pended switch on return
  * 
  */
 
+#include "os_swi.h"
+
+.set ARM_MODE_THUMB,        0x20    /* T bit in the SPSR */
+.set ARM_MODE_FIQ,          0x11
+.set ARM_MODE_IRQ,          0x12
+.set ARM_MODE_SYS,          0x1F
+.set ARM_MODE_MASK,         0x1F
+.set I_BIT,                 0x80
+.set OS_ERR,                0x80000001
 
 .text
 .code 32
 .align 0
 
 
-.extern processSWI
+.extern kos_swiTable
+.extern kos_switchPending
+.extern kos_SwitchFromSWI
 
 
-.global callSWI
 .global handleSWI
+.type handleSWI, %function
 
 
+/*
+ * SWI stubs. The caller's arguments are already in r0-r3, so a kernel
+ * service is a trap and a return. Only user mode traps, and its LR is
+ * banked away from SVC mode's, so it survives the SWI.
+ * Privileged callers skip the trap and call svc through kos_DirectCall.
+ * Set blocks for a service that can block the caller, ISRs get OS_ERR.
+ */
+.macro SWI_STUB name, num, svc, blocks=0
+	.global \name
+	.type \name, %function
+\name:
+	MRS		R12, CPSR
+	TST		R12, #0x0F					/* user mode is 0x10 */
+	BNE		1f
+	SWI		\num
+	BX		LR
+1:
+	LDR		R12, =\svc
+	.if \blocks
+	B		kos_DirectCallBlocking
+	.else
+	B		kos_DirectCall
+	.endif
+.endm
 
 /* uint32 callSWI(void *arg1, void *arg2, void *arg3, void *arg4) */
-callSWI:
-	swi 8080
+	SWI_STUB callSWI, KOS_SWI_DRIVER, processSWI
+
+/* uint32_t kos_swiCreateThread(threadCreateArgs_t *pArgs) */
+	SWI_STUB kos_swiCreateThread, KOS_SWI_CREATE_THREAD, kos_svcCreateThread
+
+/* uint32_t kos_Sleep(uint32_t ticks) */
+	SWI_STUB kos_Sleep, KOS_SWI_SLEEP, kos_svcSleep, 1
+
+/* void kos_Yield(void) */
+	SWI_STUB kos_Yield, KOS_SWI_YIELD, kos_svcYield
+
+/* uint32_t kos_SemWait(kosSem_t *pSem, uint32_t timeout) */
+	SWI_STUB kos_SemWait, KOS_SWI_SEM_WAIT, kos_svcSemWait, 1
+
+/* uint32_t kos_SemSignal(kosSem_t *pSem) */
+	SWI_STUB kos_SemSignal, KOS_SWI_SEM_SIGNAL, kos_svcSemSignal
+
+/* uint32_t kos_SemDelete(kosSem_t *pSem) */
+	SWI_STUB kos_SemDelete, KOS_SWI_SEM_DELETE, kos_svcSemDelete
+
+/* uint32_t kos_MutexLock(kosMutex_t *pMutex, uint32_t timeout) */
+	SWI_STUB kos_MutexLock, KOS_SWI_MUTEX_LOCK, kos_svcMutexLock, 1
+
+/* uint32_t kos_MutexUnlock(kosMutex_t *pMutex) */
+	SWI_STUB kos_MutexUnlock, KOS_SWI_MUTEX_UNLOCK, kos_svcMutexUnlock
+
+/* uint32_t kos_MutexDelete(kosMutex_t *pMutex) */
+	SWI_STUB kos_MutexDelete, KOS_SWI_MUTEX_DELETE, kos_svcMutexDelete
+
+/* uint32_t kos_swiEventWait(eventWaitArgs_t *pArgs) */
+	SWI_STUB kos_swiEventWait, KOS_SWI_EVENT_WAIT, kos_svcEventWait, 1
+
+/* uint32_t kos_EventSet(kosEvent_t *pEvent, uint32_t bits) */
+	SWI_STUB kos_EventSet, KOS_SWI_EVENT_SET, kos_svcEventSet
+
+/* uint32_t kos_EventClear(kosEvent_t *pEvent, uint32_t bits) */
+	SWI_STUB kos_EventClear, KOS_SWI_EVENT_CLEAR, kos_svcEventClear
+
+/* uint32_t kos_EventDelete(kosEvent_t *pEvent) */
+	SWI_STUB kos_EventDelete, KOS_SWI_EVENT_DELETE, kos_svcEventDelete
+
+/* uint32_t kos_QueueSend(kosQueue_t *pQueue, const void *pItem, uint32_t timeout) */
+	SWI_STUB kos_QueueSend, KOS_SWI_QUEUE_SEND, kos_svcQueueSend, 1
+
+/* uint32_t kos_QueueReceive(kosQueue_t *pQueue, void *pItem, uint32_t timeout) */
+	SWI_STUB kos_QueueReceive, KOS_SWI_QUEUE_RECEIVE, kos_svcQueueReceive, 1
+
+/* uint32_t kos_QueueDelete(kosQueue_t *pQueue) */
+	SWI_STUB kos_QueueDelete, KOS_SWI_QUEUE_DELETE, kos_svcQueueDelete
+
+/* uint32_t kos_BufAlloc(kosBufPool_t *pPool, kosBuf_t **ppBuf, uint32_t timeout) */
+	SWI_STUB kos_BufAlloc, KOS_SWI_BUF_ALLOC, kos_svcBufAlloc, 1
+
+/* uint32_t kos_BufAddRef(kosBuf_t *pBuf) */
+	SWI_STUB kos_BufAddRef, KOS_SWI_BUF_ADDREF, kos_svcBufAddRef
+
+/* uint32_t kos_BufRelease(kosBuf_t *pBuf) */
+	SWI_STUB kos_BufRelease, KOS_SWI_BUF_RELEASE, kos_svcBufRelease
+
+/* uint32_t kos_Notify(threadTCB_t *pThread, uint32_t value, uint32_t action) */
+	SWI_STUB kos_Notify, KOS_SWI_NOTIFY, kos_svcNotify
+
+/* uint32_t kos_NotifyWait(uint32_t timeout, uint32_t *pValue) */
+	SWI_STUB kos_NotifyWait, KOS_SWI_NOTIFY_WAIT, kos_svcNotifyWait, 1
+
+/* uint32_t kos_swiStreamWrite(streamArgs_t *pArgs) */
+	SWI_STUB kos_swiStreamWrite, KOS_SWI_STREAM_WRITE, kos_svcStreamWrite, 1
+
+/* uint32_t kos_swiStreamRead(streamArgs_t *pArgs) */
+	SWI_STUB kos_swiStreamRead, KOS_SWI_STREAM_READ, kos_svcStreamRead, 1
+
+/* uint32_t kos_RwReadLock(kosRwLock_t *pLock, uint32_t timeout) */
+	SWI_STUB kos_RwReadLock, KOS_SWI_RW_READ_LOCK, kos_svcRwReadLock, 1
+
+/* uint32_t kos_RwReadUnlock(kosRwLock_t *pLock) */
+	SWI_STUB kos_RwReadUnlock, KOS_SWI_RW_READ_UNLOCK, kos_svcRwReadUnlock
+
+/* uint32_t kos_RwWriteLock(kosRwLock_t *pLock, uint32_t timeout) */
+	SWI_STUB kos_RwWriteLock, KOS_SWI_RW_WRITE_LOCK, kos_svcRwWriteLock, 1
+
+/* uint32_t kos_RwWriteUnlock(kosRwLock_t *pLock) */
+	SWI_STUB kos_RwWriteUnlock, KOS_SWI_RW_WRITE_UNLOCK, kos_svcRwWriteUnlock
+
+/* uint32_t kos_RwDelete(kosRwLock_t *pLock) */
+	SWI_STUB kos_RwDelete, KOS_SWI_RW_DELETE, kos_svcRwDelete
+
+/* uint32_t kos_swiCondWait(kosCond_t *pCond, kosMutex_t *pMutex, uint32_t timeout) */
+	SWI_STUB kos_swiCondWait, KOS_SWI_COND_WAIT, kos_svcCondWait, 1
+
+/* uint32_t kos_CondSignal(kosCond_t *pCond) */
+	SWI_STUB kos_CondSignal, KOS_SWI_COND_SIGNAL, kos_svcCondSignal
+
+/* uint32_t kos_CondBroadcast(kosCond_t *pCond) */
+	SWI_STUB kos_CondBroadcast, KOS_SWI_COND_BROADCAST, kos_svcCondBroadcast
+
+/* uint32_t kos_CondDelete(kosCond_t *pCond) */
+	SWI_STUB kos_CondDelete, KOS_SWI_COND_DELETE, kos_svcCondDelete
+
+/* uint32_t kos_swiBarrierWait(kosBarrier_t *pBarrier, uint32_t timeout) */
+	SWI_STUB kos_swiBarrierWait, KOS_SWI_BARRIER_WAIT, kos_svcBarrierWait, 1
+
+/* uint32_t kos_BarrierDelete(kosBarrier_t *pBarrier) */
+	SWI_STUB kos_BarrierDelete, KOS_SWI_BARRIER_DELETE, kos_svcBarrierDelete
+
+/* uint32_t kos_swiWaitMultiple(multiWaitArgs_t *pArgs) */
+	SWI_STUB kos_swiWaitMultiple, KOS_SWI_WAIT_MULTIPLE, kos_svcWaitMultiple, 1
+
+/* uint32_t kos_swiWaitMultipleCancel(multiWaitArgs_t *pArgs) */
+	SWI_STUB kos_swiWaitMultipleCancel, KOS_SWI_WAIT_MULTIPLE_CANCEL, kos_svcWaitMultipleCancel
+
+/* uint32_t kos_WorkSubmit(kosWorkQueue_t *pQueue, kosWork_t *pWork) */
+	SWI_STUB kos_WorkSubmit, KOS_SWI_WORK_SUBMIT, kos_svcWorkSubmit
+
+/* uint32_t kos_swiWorkTake(kosWorkQueue_t *pQueue, kosWork_t **ppWork) */
+	SWI_STUB kos_swiWorkTake, KOS_SWI_WORK_TAKE, kos_svcWorkTake, 1
+
+/* uint32_t kos_TimerStart(kosTimer_t *pTimer, uint32_t ticks, uint32_t period) */
+	SWI_STUB kos_TimerStart, KOS_SWI_TIMER_START, kos_svcTimerStart
+
+/* uint32_t kos_TimerStop(kosTimer_t *pTimer) */
+	SWI_STUB kos_TimerStop, KOS_SWI_TIMER_STOP, kos_svcTimerStop
+
+/* uint32_t kos_swiTimerNext(kosTimerFunc_t **ppFunc, void **ppArg) */
+	SWI_STUB kos_swiTimerNext, KOS_SWI_TIMER_NEXT, kos_svcTimerNext, 1
+
+/* uint32_t kos_PoolAlloc(kosPool_t *pPool, void **ppBlock, uint32_t timeout) */
+	SWI_STUB kos_PoolAlloc, KOS_SWI_POOL_ALLOC, kos_svcPoolAlloc, 1
+
+/* uint32_t kos_PoolFree(kosPool_t *pPool, void *pBlock) */
+	SWI_STUB kos_PoolFree, KOS_SWI_POOL_FREE, kos_svcPoolFree
+
+/* void *kos_Malloc(uint32_t size) */
+	SWI_STUB kos_Malloc, KOS_SWI_HEAP_ALLOC, kos_svcHeapAlloc
+
+/* uint32_t kos_Free(void *p) */
+	SWI_STUB kos_Free, KOS_SWI_HEAP_FREE, kos_svcHeapFree
+
+/* uint32_t kos_HeapStats(kosHeapStats_t *pStats) */
+	SWI_STUB kos_HeapStats, KOS_SWI_HEAP_STATS, kos_svcHeapStats
+
+
+/* 
+ * Direct call of a service that can block, R12 is the service.
+ * 
+ * An ISR would block the thread it interrupted, which keeps running
+ * off the ready list, so IRQ and FIQ callers get OS_ERR instead.
+ */
+kos_DirectCallBlocking:
+	STMFD	SP!, {R0}
+	MRS		R0, CPSR
+	AND		R0, R0, #ARM_MODE_MASK
+	CMP		R0, #ARM_MODE_IRQ
+	CMPNE	R0, #ARM_MODE_FIQ
+	LDMFD	SP!, {R0}					/* flags are kept */
+	BNE		kos_DirectCall
+	LDR		R0, =OS_ERR
+	BX		LR
+
+/* 
+ * Direct call for privileged callers, R12 is the service.
+ * 
+ * Calls the service with IRQ disabled, the same as the SWI would, but
+ * without the trap. A trusted thread (sys mode) still needs the SWI to
+ * switch, so if the service pended one it traps with KOS_SWI_SWITCH,
+ * which passes r0 through. ISRs and the kernel itself leave the switch
+ * to the next tick or SWI.
+ */
+kos_DirectCall:
+	STMFD	SP!, {R4, LR}
+	MRS		R4, CPSR
+	ORR		LR, R4, #I_BIT
+	MSR		CPSR_c, LR
+	MOV		LR, PC
+	BX		R12							/* r0 = service(r0, r1, r2, r3) */
 	
-/* uint32 handleSWI(void *arg1, void *arg2, void *arg3, void *arg4) */
-/* eventually save state, re-enable interrupts, and handle different swi numbers */	
+	AND		R1, R4, #ARM_MODE_MASK
+	CMP		R1, #ARM_MODE_SYS
+	BNE		1f
+	LDR		R1, =kos_switchPending
+	LDR		R1, [R1]
+	CMP		R1, #0
+	SWINE	KOS_SWI_SWITCH				/* resumes here, r0 patched if we blocked */
+1:
+	MSR		CPSR_c, R4
+	LDMFD	SP!, {R4, LR}
+	BX		LR
+
+	.ltorg
+
+/* the SWI vector is part of the switch path and runs from RAM */
+.section .ramfunc, "ax"
+.code 32
+.align 0
+
+/* 
+ * SWI vector.
+ * 
+ * Decodes the SWI number from the trapping instruction and calls the
+ * service in kos_swiTable with the caller's r0-r3. IRQ stays disabled
+ * for the whole service. The service's return value goes back in r0.
+ * If the service pended a switch the caller's context is saved and the
+ * next thread restored instead of returning.
+ */
 handleSWI:
-	stmfd 	sp!, {lr}
-	bl 		processSWI
-	ldmfd	sp!, {pc}
+	STMFD	SP!, {R12, LR}
+
+	/* Fetch the SWI number from the instruction that trapped */
+	MRS		R12, SPSR
+	TST		R12, #ARM_MODE_THUMB
+	LDRNEH	R12, [LR, #-2]				/* Thumb: 8 bit immediate */
+	BICNE	R12, R12, #0xFF00
+	LDREQ	R12, [LR, #-4]				/* ARM: 24 bit immediate */
+	BICEQ	R12, R12, #0xFF000000
+
+	CMP		R12, #KOS_SWI_COUNT
+	LDRHS	R0, =OS_ERR					/* unknown service */
+	LDMHSFD	SP!, {R12, PC}^
+
+	LDR		LR, =kos_swiTable
+	LDR		R12, [LR, R12, LSL #2]
+	MOV		LR, PC
+	BX		R12							/* r0 = service(r0, r1, r2, r3) */
+
+	LDR		R1, =kos_switchPending
+	LDR		R1, [R1]
+	CMP		R1, #0
+	LDMEQFD	SP!, {R12, PC}^				/* return to the caller */
 
+	/* Switch: LR is the caller's resume address, r0 its return value */
+	LDMFD	SP!, {R12, LR}
+	B		kos_SwitchFromSWI
 
+.end
@@ -0,0 +1,80 @@
+/** 
+ * 
+ * \file os_swi_table.c
+ * Kernel service table for the SWI handler
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_swi.h"
+
+//------------------------------------------------------------------------
+// External Functions
+extern uint32_t processSWI(uint32_t arg1, uint32_t arg2, uint32_t arg3, uint32_t arg4);
+
+//------------------------------------------------------------------------
+// Globals
+
+// handleSWI in os_swi.s indexes this table with the SWI number and calls
+// the service with the caller's r0-r3
+kosSwiFunc_t * const kos_swiTable[KOS_SWI_COUNT] = {
+	[KOS_SWI_DRIVER]            = processSWI,
+	[KOS_SWI_CREATE_THREAD]     = (kosSwiFunc_t*)kos_svcCreateThread,
+	[KOS_SWI_SLEEP]             = (kosSwiFunc_t*)kos_svcSleep,
+	[KOS_SWI_YIELD]             = (kosSwiFunc_t*)kos_svcYield,
+	[KOS_SWI_SWITCH]            = (kosSwiFunc_t*)kos_svcSwitch,
+	[KOS_SWI_SEM_WAIT]          = (kosSwiFunc_t*)kos_svcSemWait,
+	[KOS_SWI_SEM_SIGNAL]        = (kosSwiFunc_t*)kos_svcSemSignal,
+	[KOS_SWI_SEM_DELETE]        = (kosSwiFunc_t*)kos_svcSemDelete,
+	[KOS_SWI_MUTEX_LOCK]        = (kosSwiFunc_t*)kos_svcMutexLock,
+	[KOS_SWI_MUTEX_UNLOCK]      = (kosSwiFunc_t*)kos_svcMutexUnlock,
+	[KOS_SWI_MUTEX_DELETE]      = (kosSwiFunc_t*)kos_svcMutexDelete,
+	[KOS_SWI_EVENT_WAIT]        = (kosSwiFunc_t*)kos_svcEventWait,
+	[KOS_SWI_EVENT_SET]         = (kosSwiFunc_t*)kos_svcEventSet,
+	[KOS_SWI_EVENT_CLEAR]       = (kosSwiFunc_t*)kos_svcEventClear,
+	[KOS_SWI_EVENT_DELETE]      = (kosSwiFunc_t*)kos_svcEventDelete,
+	[KOS_SWI_QUEUE_SEND]        = (kosSwiFunc_t*)kos_svcQueueSend,
+	[KOS_SWI_QUEUE_RECEIVE]     = (kosSwiFunc_t*)kos_svcQueueReceive,
+	[KOS_SWI_QUEUE_DELETE]      = (kosSwiFunc_t*)kos_svcQueueDelete,
+	[KOS_SWI_BUF_ALLOC]         = (kosSwiFunc_t*)kos_svcBufAlloc,
+	[KOS_SWI_BUF_ADDREF]        = (kosSwiFunc_t*)kos_svcBufAddRef,
+	[KOS_SWI_BUF_RELEASE]       = (kosSwiFunc_t*)kos_svcBufRelease,
+	[KOS_SWI_NOTIFY]            = (kosSwiFunc_t*)kos_svcNotify,
+	[KOS_SWI_NOTIFY_WAIT]       = (kosSwiFunc_t*)kos_svcNotifyWait,
+	[KOS_SWI_STREAM_WRITE]      = (kosSwiFunc_t*)kos_svcStreamWrite,
+	[KOS_SWI_STREAM_READ]       = (kosSwiFunc_t*)kos_svcStreamRead,
+	[KOS_SWI_RW_READ_LOCK]      = (kosSwiFunc_t*)kos_svcRwReadLock,
+	[KOS_SWI_RW_READ_UNLOCK]    = (kosSwiFunc_t*)kos_svcRwReadUnlock,
+	[KOS_SWI_RW_WRITE_LOCK]     = (kosSwiFunc_t*)kos_svcRwWriteLock,
+	[KOS_SWI_RW_WRITE_UNLOCK]   = (kosSwiFunc_t*)kos_svcRwWriteUnlock,
+	[KOS_SWI_RW_DELETE]         = (kosSwiFunc_t*)kos_svcRwDelete,
+	[KOS_SWI_COND_WAIT]         = (kosSwiFunc_t*)kos_svcCondWait,
+	[KOS_SWI_COND_SIGNAL]       = (kosSwiFunc_t*)kos_svcCondSignal,
+	[KOS_SWI_COND_BROADCAST]    = (kosSwiFunc_t*)kos_svcCondBroadcast,
+	[KOS_SWI_COND_DELETE]       = (kosSwiFunc_t*)kos_svcCondDelete,
+	[KOS_SWI_BARRIER_WAIT]      = (kosSwiFunc_t*)kos_svcBarrierWait,
+	[KOS_SWI_BARRIER_DELETE]    = (kosSwiFunc_t*)kos_svcBarrierDelete,
+	[KOS_SWI_WAIT_MULTIPLE]     = (kosSwiFunc_t*)kos_svcWaitMultiple,
+	[KOS_SWI_WAIT_MULTIPLE_CANCEL] = (kosSwiFunc_t*)kos_svcWaitMultipleCancel,
+	[KOS_SWI_WORK_SUBMIT]       = (kosSwiFunc_t*)kos_svcWorkSubmit,
+	[KOS_SWI_WORK_TAKE]         = (kosSwiFunc_t*)kos_svcWorkTake,
+	[KOS_SWI_TIMER_START]       = (kosSwiFunc_t*)kos_svcTimerStart,
+	[KOS_SWI_TIMER_STOP]        = (kosSwiFunc_t*)kos_svcTimerStop,
+	[KOS_SWI_TIMER_NEXT]        = (kosSwiFunc_t*)kos_svcTimerNext,
+	[KOS_SWI_ATOMIC_CAS]        = (kosSwiFunc_t*)kos_svcAtomicCas,
+	[KOS_SWI_ATOMIC_ADD]        = (kosSwiFunc_t*)kos_svcAtomicAdd,
+	[KOS_SWI_ATOMIC_SET_BITS]   = (kosSwiFunc_t*)kos_svcAtomicSetBits,
+	[KOS_SWI_ATOMIC_CLEAR_BITS] = (kosSwiFunc_t*)kos_svcAtomicClearBits,
+	[KOS_SWI_POOL_ALLOC]        = (kosSwiFunc_t*)kos_svcPoolAlloc,
+	[KOS_SWI_POOL_FREE]         = (kosSwiFunc_t*)kos_svcPoolFree,
+	[KOS_SWI_HEAP_ALLOC]        = (kosSwiFunc_t*)kos_svcHeapAlloc,
+	[KOS_SWI_HEAP_FREE]         = (kosSwiFunc_t*)kos_svcHeapFree,
+	[KOS_SWI_HEAP_STATS]        = (kosSwiFunc_t*)kos_svcHeapStats,
+};
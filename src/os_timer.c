@@ -0,0 +1,280 @@
+/** 
+ * 
+ * \file os_timer.c
+ * Software timers
+ *
+ * Running timers are hashed on their expiry tick into the slots of a
+ * wheel, so starting and stopping one is O(1). The wheel keeps its own
+ * time, the tick it is scanning, which the timer thread moves up to the
+ * kernel tick one slot at a time. A slot holds the timers of every
+ * round, those due in a later round are skipped. If the scan falls more
+ * than a turn behind it jumps to the last turn, whose slots between
+ * them hold every timer that is due.
+ *
+ * The timer thread sleeps until the next slot with timers in it, or
+ * for ever if there are none. A start that is due sooner wakes it
+ * early to sleep again for the right time.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_kernel.h"
+#include "os_timer.h"
+
+#define KOS_TIMER_SLOT(tick)    ((tick) & (KOS_TIMER_WHEEL_SIZE-1))
+
+//--------------------------------------------------------------
+// external functions
+
+extern uint32_t kos_swiTimerNext(kosTimerFunc_t **ppFunc, void **ppArg);
+
+//--------------------------------------------------------------
+// file local variables
+
+static kosTimer_t *kos_timerWheel[KOS_TIMER_WHEEL_SIZE] = {0};
+
+static uint32_t kos_timerScan = 0;			// tick of the slot being scanned
+
+static uint32_t kos_timerWakeAt = 0;		// tick the timer thread sleeps to
+
+static kosWaitList_t kos_timerList = {0};	// the timer thread, while it sleeps
+
+static uint32_t kos_timerIdle = FALSE;		// the timer thread sleeps for ever on an empty wheel
+
+//--------------------------------------------------------------
+// local function prototypes
+static void kos_TimerInsert(kosTimer_t *pTimer);
+static void kos_TimerRemove(kosTimer_t *pTimer);
+static void kos_TimerThread(void *pData);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Put a timer in the slot of its expiry tick.
+ */
+static void kos_TimerInsert(kosTimer_t *pTimer)
+{
+	kosTimer_t **ppSlot;
+	
+	// a periodic timer running late goes in the slot being scanned, to fire again at once
+	if ((int32_t)(pTimer->expire - kos_timerScan) < 0)
+	{
+		pTimer->slot = KOS_TIMER_SLOT(kos_timerScan);
+	}
+	else
+	{
+		pTimer->slot = KOS_TIMER_SLOT(pTimer->expire);
+	}
+	ppSlot = &kos_timerWheel[pTimer->slot];
+	
+	pTimer->pPrev = 0;
+	pTimer->pNext = *ppSlot;
+	if (*ppSlot)
+	{
+		(*ppSlot)->pPrev = pTimer;
+	}
+	*ppSlot = pTimer;
+	pTimer->active = TRUE;
+}
+
+/*
+ * Take a running timer out of its slot.
+ */
+static void kos_TimerRemove(kosTimer_t *pTimer)
+{
+	if (pTimer->pPrev)
+	{
+		pTimer->pPrev->pNext = pTimer->pNext;
+	}
+	else
+	{
+		// the scan slot rather than its own if it was late, and the scan may have moved since
+		kos_timerWheel[pTimer->slot] = pTimer->pNext;
+	}
+	if (pTimer->pNext)
+	{
+		pTimer->pNext->pPrev = pTimer->pPrev;
+	}
+	
+	pTimer->pNext = 0;
+	pTimer->pPrev = 0;
+	pTimer->active = FALSE;
+}
+
+/*
+ * Timer thread, calls the timer functions as they fire.
+ */
+static void kos_TimerThread(void *pData)
+{
+	kosTimerFunc_t *pFunc;
+	void *pArg;
+	
+	while (1)
+	{
+		if (OS_NO_ERR == kos_swiTimerNext(&pFunc, &pArg))
+		{
+			pFunc(pArg);
+		}
+	}
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Start a timer. Kernel side of kos_TimerStart.
+ */
+uint32_t kos_svcTimerStart(kosTimer_t *pTimer, uint32_t ticks, uint32_t period)
+{
+	if ((0 == pTimer) || (0 == pTimer->pFunc) || (0 == ticks))
+	{
+		return ERR_ARG;
+	}
+	
+	if (pTimer->active)
+	{
+		kos_TimerRemove(pTimer);
+	}
+	
+	// nothing was scanned while the wheel was empty, start from now
+	if (kos_timerIdle)
+	{
+		kos_timerScan = kos_TickCount();
+		kos_timerIdle = FALSE;
+	}
+	
+	pTimer->expire = kos_TickCount() + ticks;
+	pTimer->period = period;
+	kos_TimerInsert(pTimer);
+	
+	// the timer thread sleeps past it, wake it to work out its sleep again
+	if (kos_timerList.pHead && ((int32_t)(pTimer->expire - kos_timerWakeAt) < 0))
+	{
+		kos_WaitWakeOne(&kos_timerList, OS_ERR_TIMEOUT);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Stop a timer. Kernel side of kos_TimerStop.
+ */
+uint32_t kos_svcTimerStop(kosTimer_t *pTimer)
+{
+	if (0 == pTimer)
+	{
+		return ERR_ARG;
+	}
+	
+	if (pTimer->active)
+	{
+		kos_TimerRemove(pTimer);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Take the next timer that has fired, or sleep until one may have.
+ * Kernel side of the timer thread.
+ */
+uint32_t kos_svcTimerNext(kosTimerFunc_t **ppFunc, void **ppArg)
+{
+	uint32_t now = kos_TickCount();
+	kosTimer_t *pTimer;
+	uint32_t d;
+	
+	// a starved thread catches up in one turn, each slot fires all that is due
+	if ((now - kos_timerScan) >= KOS_TIMER_WHEEL_SIZE)
+	{
+		kos_timerScan = now - (KOS_TIMER_WHEEL_SIZE - 1);
+	}
+	
+	while (1)
+	{
+		for (pTimer = kos_timerWheel[KOS_TIMER_SLOT(kos_timerScan)]; pTimer; pTimer = pTimer->pNext)
+		{
+			if ((int32_t)(pTimer->expire - kos_timerScan) <= 0)
+			{
+				// copied, so the timer may be restarted before its function runs
+				*ppFunc = pTimer->pFunc;
+				*ppArg = pTimer->pArg;
+				
+				kos_TimerRemove(pTimer);
+				if (pTimer->period)
+				{
+					pTimer->expire += pTimer->period;
+					kos_TimerInsert(pTimer);
+				}
+				return OS_NO_ERR;
+			}
+		}
+		
+		if (kos_timerScan == now)
+		{
+			break;
+		}
+		kos_timerScan++;
+	}
+	
+	// sleep to the next slot with a timer in it, at most one turn of the wheel
+	for (d = 1; d <= KOS_TIMER_WHEEL_SIZE; d++)
+	{
+		if (kos_timerWheel[KOS_TIMER_SLOT(now + d)])
+		{
+			kos_timerWakeAt = now + d;
+			return kos_WaitBlock(&kos_timerList, d);
+		}
+	}
+	
+	kos_timerWakeAt = now + 0x7FFFFFFF;	// as far off as a tick compare reaches
+	kos_timerIdle = TRUE;
+	
+	return kos_WaitBlock(&kos_timerList, KOS_WAIT_FOREVER);
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Start the timer thread. Documented in os_timer.h
+ */
+uint32_t kos_TimerServiceStart(uint8_t pri, KOS_STK *stack, uint32_t stackSize)
+{
+	kos_timerScan = kos_TickCount();
+	
+	return kos_CreateThread(pri, "kos timer", stack, stackSize, kos_TimerThread, 0);
+}
+
+/*
+ * Set up a timer. Documented in os_timer.h
+ */
+uint32_t kos_TimerInit(kosTimer_t *pTimer, kosTimerFunc_t *pFunc, void *pArg)
+{
+	if ((0 == pTimer) || (0 == pFunc))
+	{
+		return ERR_ARG;
+	}
+	
+	pTimer->pNext = 0;
+	pTimer->pPrev = 0;
+	pTimer->pFunc = pFunc;
+	pTimer->pArg = pArg;
+	pTimer->expire = 0;
+	pTimer->period = 0;
+	pTimer->active = FALSE;
+	pTimer->slot = 0;
+	
+	return OS_NO_ERR;
+}
+
+/**** End Public Functions ****/
@@ -0,0 +1,236 @@
+/** 
+ * 
+ * \file os_work.c
+ * Work queues
+ *
+ * The items are an intrusive FIFO, so submitting is O(1). ISRs link
+ * items in directly, the kernel only changes the list with IRQ
+ * disabled, and post to the kernel only when a worker is idle. An idle
+ * worker's pWaitData is where the item it is handed goes.
+ *
+ * History:
+ * 18 OCT 2026 : Created
+ * 
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lpc-2378-stk.h"
+#include "error_codes.h"
+#include "os_core.h"
+#include "os_post.h"
+#include "os_kernel.h"
+#include "os_work.h"
+
+//--------------------------------------------------------------
+// external functions
+
+extern uint32_t kos_swiWorkTake(kosWorkQueue_t *pQueue, kosWork_t **ppWork);
+
+//--------------------------------------------------------------
+// local function prototypes
+static KOS_RAMFUNC void kos_WorkPut(kosWorkQueue_t *pQueue, kosWork_t *pWork);
+static kosWork_t *kos_WorkGet(kosWorkQueue_t *pQueue);
+static void kos_WorkPostWake(void *pArg);
+static void kos_WorkThread(void *pData);
+
+//--------------------------------------------------------------
+// functions
+
+/*
+ * Link an item to the back of the queue, unless it is already on it.
+ */
+static KOS_RAMFUNC void kos_WorkPut(kosWorkQueue_t *pQueue, kosWork_t *pWork)
+{
+	if (pWork->pending)
+	{
+		return;
+	}
+	
+	pWork->pending = 1;
+	pWork->pNext = 0;
+	if (pQueue->pTail)
+	{
+		pQueue->pTail->pNext = pWork;
+	}
+	else
+	{
+		pQueue->pHead = pWork;
+	}
+	pQueue->pTail = pWork;
+}
+
+/*
+ * Unlink the item at the front of the queue, 0 if it is empty.
+ */
+static kosWork_t *kos_WorkGet(kosWorkQueue_t *pQueue)
+{
+	kosWork_t *pWork = pQueue->pHead;
+	
+	if (pWork)
+	{
+		pQueue->pHead = pWork->pNext;
+		if (0 == pQueue->pHead)
+		{
+			pQueue->pTail = 0;
+		}
+		pWork->pending = 0;
+	}
+	
+	return pWork;
+}
+
+/*
+ * Worker thread, runs items until the end of time.
+ */
+static void kos_WorkThread(void *pData)
+{
+	kosWorkQueue_t *pQueue = (kosWorkQueue_t *)pData;
+	kosWork_t *pWork;
+	
+	while (1)
+	{
+		if (OS_NO_ERR == kos_swiWorkTake(pQueue, &pWork))
+		{
+			pWork->pFunc(pWork->pArg);
+		}
+	}
+}
+
+/**** Kernel Functions ****/
+
+/*
+ * Submit a work item. Kernel side of kos_WorkSubmit.
+ */
+uint32_t kos_svcWorkSubmit(kosWorkQueue_t *pQueue, kosWork_t *pWork)
+{
+	if ((0 == pQueue) || (0 == pWork) || (0 == pWork->pFunc))
+	{
+		return ERR_ARG;
+	}
+	
+	// behind the items an ISR queued, even if their post has not been drained
+	kos_WorkPut(pQueue, pWork);
+	kos_WorkPostWake(pQueue);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Wait for a work item. Kernel side of the worker thread.
+ */
+uint32_t kos_svcWorkTake(kosWorkQueue_t *pQueue, kosWork_t **ppWork)
+{
+	// workers an ISR's lost wake left idle go first
+	kos_WorkPostWake(pQueue);
+	
+	*ppWork = kos_WorkGet(pQueue);
+	if (*ppWork)
+	{
+		return OS_NO_ERR;
+	}
+	
+	kos_threadCurr->pWaitData = ppWork;
+	
+	return kos_WaitBlock(&pQueue->waitList, KOS_WAIT_FOREVER);
+}
+
+/*
+ * kos_WorkSubmitFromISR request, hands the queued items to idle workers.
+ */
+static void kos_WorkPostWake(void *pArg)
+{
+	kosWorkQueue_t *pQueue = (kosWorkQueue_t *)pArg;
+	threadTCB_t *pThread;
+	
+	while (pQueue->pHead && pQueue->waitList.pHead)
+	{
+		pThread = pQueue->waitList.pHead;
+		*(kosWork_t **)pThread->pWaitData = kos_WorkGet(pQueue);
+		kos_ThreadWake(pThread, OS_NO_ERR);
+	}
+}
+
+/**** End Kernel Functions ****/
+
+
+/**** Public Functions ****/
+
+/*
+ * Create a work queue. Documented in os_work.h
+ */
+uint32_t kos_WorkQueueCreate(kosWorkQueue_t *pQueue)
+{
+	if (0 == pQueue)
+	{
+		return ERR_ARG;
+	}
+	
+	pQueue->pHead = 0;
+	pQueue->pTail = 0;
+	kos_WaitListInit(&pQueue->waitList);
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Add a worker thread. Documented in os_work.h
+ */
+uint32_t kos_WorkQueueStart(kosWorkQueue_t *pQueue, uint8_t pri, const char *pszName, KOS_STK *stack, uint32_t stackSize)
+{
+	if (0 == pQueue)
+	{
+		return ERR_ARG;
+	}
+	
+	return kos_CreateThread(pri, pszName, stack, stackSize, kos_WorkThread, pQueue);
+}
+
+/*
+ * Set up a work item. Documented in os_work.h
+ */
+uint32_t kos_WorkInit(kosWork_t *pWork, kosWorkFunc_t *pFunc, void *pArg)
+{
+	if ((0 == pWork) || (0 == pFunc))
+	{
+		return ERR_ARG;
+	}
+	
+	pWork->pNext = 0;
+	pWork->pFunc = pFunc;
+	pWork->pArg = pArg;
+	pWork->pending = 0;
+	
+	return OS_NO_ERR;
+}
+
+/*
+ * Submit a work item from an ISR. Documented in os_work.h
+ */
+KOS_RAMFUNC uint32_t kos_WorkSubmitFromISR(kosWorkQueue_t *pQueue, kosWork_t *pWork)
+{
+	uint32_t cpsr;
+	uint32_t wake;
+	
+	if ((0 == pQueue) || (0 == pWork) || (0 == pWork->pFunc))
+	{
+		return ERR_ARG;
+	}
+	
+	// only needed if a higher priority IRQ can nest and submit too
+	cpsr = InterruptsDisable();
+	kos_WorkPut(pQueue, pWork);
+	wake = (0 != pQueue->waitList.pHead);
+	InterruptsRestore(cpsr);
+	
+	// also when the item was already pending, in case its wake was lost.
+	// OS_ERR_POST_FULL still leaves the item queued
+	if (wake)
+	{
+		return kos_PostFromISR(kos_WorkPostWake, pQueue);
+	}
+	
+	return OS_NO_ERR;
+}
+
+/**** End Public Functions ****/